@@ -25,6 +25,7 @@
 #include "clang/Frontend/ASTUnit.h"
 #include "clang/Sema/Initialization.h"
 #include "clang/Sema/Lookup.h"
+#include "clang/Sema/Overload.h"
 #include "clang/Sema/Sema.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/CommandLine.h"
@@ -367,6 +368,23 @@ bool TranslationUnitAST::Init(const std::string& code,
   return true;
 }
 
+std::vector<std::string> TranslationUnitAST::GetIncludedFiles() const {
+  const clang::SourceManager& source_manager =
+      GetASTContext().getSourceManager();
+  const clang::FileEntry* main_file =
+      source_manager.getFileEntryForID(source_manager.getMainFileID());
+  std::set<std::string> files;
+  for (auto it = source_manager.fileinfo_begin();
+       it != source_manager.fileinfo_end(); ++it) {
+    const clang::FileEntry* file = it->first;
+    if (file == nullptr || file == main_file) {
+      continue;
+    }
+    files.insert(file->getName().str());
+  }
+  return std::vector<std::string>(files.begin(), files.end());
+}
+
 bool TranslationUnitAST::HasDefaultConstructor(
     clang::CXXRecordDecl* class_decl) const {
   return ConstructorIsAccessible(
@@ -404,6 +422,83 @@ bool TranslationUnitAST::IsClifMovable(clang::CXXRecordDecl* class_decl) const {
   return move_constructor && move_assignment;
 }
 
+bool TranslationUnitAST::HasComparisonOperator(
+    clang::CXXRecordDecl* class_decl, clang::BinaryOperatorKind op) {
+  clang::ASTContext& context = GetASTContext();
+  Sema& sema = GetSema();
+  QualType operand_type = context.getRecordType(class_decl).withConst();
+  auto* lhs = new (context)
+      clang::OpaqueValueExpr(SourceLocation(), operand_type, clang::VK_LValue);
+  auto* rhs = new (context)
+      clang::OpaqueValueExpr(SourceLocation(), operand_type, clang::VK_LValue);
+  // Deleted, inaccessible or ambiguous operators are errors, not diagnosed
+  // within the trap.
+  Sema::SFINAETrap trap(sema, true);  // Access checking SFINAE.
+  // Without a scope only argument-dependent lookup finds operators, which
+  // covers members and operators declared with the class.
+  clang::ExprResult result =
+      sema.BuildBinOp(nullptr, SourceLocation(), op, lhs, rhs);
+  if (!result.isInvalid()) {
+    result = sema.PerformContextuallyConvertToBool(result.get());
+  }
+  return !result.isInvalid() && !trap.hasErrorOccurred();
+}
+
+bool TranslationUnitAST::HasStdHashSpecialization(
+    clang::CXXRecordDecl* class_decl) {
+  clang::ClassTemplateDecl* hash_decl = GetStdTemplateDecl("hash");
+  if (hash_decl == nullptr) {
+    return false;
+  }
+  QualType hash_type = BuildTemplateType(
+      hash_decl, GetASTContext().getRecordType(class_decl));
+  if (hash_type.isNull()) {
+    return false;
+  }
+  // Unlike the primary template, which libc++ and libstdc++ define (as a
+  // disabled hash) for every type, a specialization is written for the class.
+  auto* specialization =
+      llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(
+          hash_type->getAsCXXRecordDecl());
+  return specialization != nullptr &&
+         specialization->isExplicitSpecialization();
+}
+
+bool TranslationUnitAST::HasAbslHashValue(clang::CXXRecordDecl* class_decl) {
+  clang::ASTContext& context = GetASTContext();
+  Sema& sema = GetSema();
+  // The state passed by absl::Hash, or an int (which a template H matches)
+  // when absl/hash/hash.h is not included: an overload for a concrete state
+  // type then can't be declared either.
+  QualType state_type = context.IntTy;
+  ClifLookupResult state =
+      LookupScopedSymbolInContext(GetTU(), "absl::HashState");
+  if (state.Size() == 1) {
+    if (auto* type_decl = llvm::dyn_cast<clang::TypeDecl>(state.GetFirst())) {
+      state_type = context.getTypeDeclType(type_decl);
+    }
+  }
+  QualType arg_type = context.getRecordType(class_decl).withConst();
+  // AbslHashValue(std::move(state), const T&), resolved like the call in
+  // absl::Hash: an AbslHashValue found for another type of the namespace is
+  // not viable.
+  clang::Expr* args[] = {
+      new (context) clang::OpaqueValueExpr(SourceLocation(), state_type,
+                                           clang::VK_XValue),
+      new (context) clang::OpaqueValueExpr(SourceLocation(), arg_type,
+                                           clang::VK_LValue)};
+  Sema::SFINAETrap trap(sema, true);  // Access checking SFINAE.
+  clang::OverloadCandidateSet candidates(
+      SourceLocation(), clang::OverloadCandidateSet::CSK_Normal);
+  sema.AddArgumentDependentLookupCandidates(
+      clang::DeclarationName(&context.Idents.get("AbslHashValue")),
+      SourceLocation(), args, nullptr, candidates);
+  clang::OverloadCandidateSet::iterator best;
+  return candidates.BestViableFunction(sema, SourceLocation(), best) ==
+             clang::OR_Success &&
+         !trap.hasErrorOccurred();
+}
+
 bool TranslationUnitAST::MethodIsAccessible(
     const clang::CXXMethodDecl* method) const {
   return (method && !method->isDeleted() &&
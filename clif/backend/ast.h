@@ -310,6 +310,11 @@ class TranslationUnitAST {
     }
   }
 
+  // Return the sorted names of all files clang read while parsing the
+  // translation unit, except for the in-memory main file. Suitable for
+  // writing a Makefile-style depfile.
+  std::vector<std::string> GetIncludedFiles() const;
+
   bool IsKnownPtrConversionType(const clang::QualType clang_type) {
     return IsKnownConversionType(clang_type, ptr_conversions_);
   }
@@ -332,6 +337,19 @@ class TranslationUnitAST {
 
   bool IsClifMovable(clang::CXXRecordDecl* class_decl) const;
 
+  // Can two const lvalues of the class be compared with |op| (BO_EQ or
+  // BO_LT), by a member, friend or namespace-scope operator, with a result
+  // convertible to bool?
+  bool HasComparisonOperator(clang::CXXRecordDecl* class_decl,
+                             clang::BinaryOperatorKind op);
+
+  // Is std::hash explicitly specialized for the class?
+  bool HasStdHashSpecialization(clang::CXXRecordDecl* class_decl);
+
+  // Does AbslHashValue(hash_state, const class&) resolve, by
+  // argument-dependent lookup, to a viable function?
+  bool HasAbslHashValue(clang::CXXRecordDecl* class_decl);
+
   bool ConstructorIsAccessible(clang::CXXConstructorDecl* ctor) const;
 
   bool MethodIsAccessible(const clang::CXXMethodDecl* method) const;
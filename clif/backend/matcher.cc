@@ -352,6 +352,13 @@ bool ClifMatcher::RunCompiler(const std::string& code,
   return ast_->Init(code, args, input_file_name);
 }
 
+std::vector<std::string> ClifMatcher::GetIncludedFiles() const {
+  if (ast_ == nullptr) {
+    return {};
+  }
+  return ast_->GetIncludedFiles();
+}
+
 bool ClifMatcher::CheckConstant(QualType type) const {
   if (!type.isConstQualified()) {
     ClifError error(*this, kConstVarError);
@@ -1066,9 +1073,26 @@ bool ClifMatcher::MatchAndSetClass(ClassDecl* class_decl) {
           clif_type->second.qual_type.getSingleStepDesugaredType(
               ast_->GetASTContext())));
   class_decl->set_is_cpp_polymorphic(record_decl->isPolymorphic());
+  SetValueSemantics(record_decl, class_decl);
   return num_unmatched == 0;
 }
 
+void ClifMatcher::SetValueSemantics(clang::CXXRecordDecl* clang_decl,
+                                    ClassDecl* clif_decl) const {
+  if (ast_->HasComparisonOperator(clang_decl, clang::BO_EQ)) {
+    clif_decl->set_cpp_has_eq(true);
+  }
+  if (ast_->HasComparisonOperator(clang_decl, clang::BO_LT)) {
+    clif_decl->set_cpp_has_lt(true);
+  }
+  // A std::hash specialization needs no extra header in the generated code.
+  if (ast_->HasStdHashSpecialization(clang_decl)) {
+    clif_decl->set_cpp_hasher("::std::hash");
+  } else if (ast_->HasAbslHashValue(clang_decl)) {
+    clif_decl->set_cpp_hasher("::absl::Hash");
+  }
+}
+
 bool ClifMatcher::MatchAndSetEnum(EnumDecl* enum_decl) {
   auto clif_qual_type = clif_qual_types_.find(enum_decl->name().cpp_name());
   assert(clif_qual_type != clif_qual_types_.end());
@@ -197,6 +197,10 @@ class ClifMatcher {
 
   const std::string GetDeclCppName(const Decl& decl) const;
 
+  // Files read by the compiler during the last RunCompiler call. Empty if
+  // the compiler has not been run.
+  std::vector<std::string> GetIncludedFiles() const;
+
   // The data structure to store typemaps. Uses std::vector<std::string> as the
   // value of the hashmap because CLIF needs to retain the order of the type
   // candidates in typemaps.
@@ -233,6 +237,11 @@ class ClifMatcher {
   bool CalculateBaseClasses(const clang::CXXRecordDecl* clang_decl,
                             ClassDecl* clif_decl) const;
 
+  // Helper for MatchAndSetClass: sets the C++ comparison and hash properties
+  // that native tp_richcompare and tp_hash slots are generated from.
+  void SetValueSemantics(clang::CXXRecordDecl* clang_decl,
+                         ClassDecl* clif_decl) const;
+
   // Construct the hash function for the keys of
   // std::unordered_set<clang::ClassTemplateSpecializationDecl*>.
   class HashFuncTemplateSpecDecl {
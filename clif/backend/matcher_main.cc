@@ -33,6 +33,11 @@ llvm::cl::opt<std::string> FLAGS_output_file(
     "output_file",
     llvm::cl::desc("Name of a file to write the matched proto."),
     llvm::cl::init(""));
+llvm::cl::opt<std::string> FLAGS_dep_file(
+    "dep_file",
+    llvm::cl::desc("Name of a file to write a Makefile-style list of the "
+                   "headers read while matching."),
+    llvm::cl::init(""));
 llvm::cl::list<std::string> FLAGS_compiler_args(
     llvm::cl::Sink,
     llvm::cl::desc("<compiler arguments>..."));
@@ -40,6 +45,35 @@ llvm::cl::list<std::string> FLAGS_compiler_args(
 using clif::protos::AST;
 using clif::ClifMatcher;
 
+// Escape a filename for use in a Makefile dependency rule.
+static std::string EscapeDepFileName(const std::string& name) {
+  std::string escaped;
+  for (char c : name) {
+    if (c == ' ' || c == '#') {
+      escaped.push_back('\\');
+    } else if (c == '$') {
+      escaped.push_back('$');
+    }
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+static bool WriteDepFile(const std::string& dep_file,
+                         const std::string& target,
+                         const std::vector<std::string>& deps) {
+  std::ofstream dep_stream(dep_file, std::fstream::out | std::fstream::trunc);
+  if (!dep_stream.is_open()) {
+    return false;
+  }
+  dep_stream << EscapeDepFileName(target) << ":";
+  for (const auto& dep : deps) {
+    dep_stream << " \\\n  " << EscapeDepFileName(dep);
+  }
+  dep_stream << "\n";
+  return dep_stream.good();
+}
+
 int main(int argc, char* argv[]) {
   std::string output_file;
   std::string input_file;
@@ -101,6 +135,12 @@ int main(int argc, char* argv[]) {
                                             input_proto,
                                             &output_proto);
 
+  if (!FLAGS_dep_file.empty() &&
+      !WriteDepFile(FLAGS_dep_file, output_file, matcher.GetIncludedFiles())) {
+    llvm::errs() << "Couldn't write dependency file " << FLAGS_dep_file;
+    return 1;
+  }
+
   std::ofstream output_stream;
   output_stream.open(output_file,
                      std::fstream::out |
@@ -3868,4 +3868,49 @@ TEST_F(ClifMatcherTest, TestPolymorphicClass) {
   EXPECT_FALSE(decl.class_().is_cpp_polymorphic());
 }
 
+TEST_F(ClifMatcherTest, TestValueSemantics) {
+  protos::Decl decl;
+  std::string decl_proto =
+      "decltype: CLASS class_ {"
+      " name { cpp_name: 'HashableByStd' }"
+      "   members {"
+      "     decltype: FUNC func { name { cpp_name: 'Method' } }"
+      "   }"
+      " }";
+  TestMatch(decl_proto, &decl);
+  EXPECT_TRUE(decl.class_().cpp_has_eq());
+  EXPECT_FALSE(decl.class_().cpp_has_lt());
+  EXPECT_EQ(decl.class_().cpp_hasher(), "::std::hash");
+  decl_proto =
+      "decltype: CLASS class_ {"
+      " name { cpp_name: 'hashable::OrderedByAbsl' }"
+      "   members {"
+      "     decltype: FUNC func { name { cpp_name: 'Method' } }"
+      "   }"
+      " }";
+  TestMatch(decl_proto, &decl);
+  EXPECT_TRUE(decl.class_().cpp_has_eq());
+  EXPECT_TRUE(decl.class_().cpp_has_lt());
+  EXPECT_EQ(decl.class_().cpp_hasher(), "::absl::Hash");
+  decl_proto =
+      "decltype: CLASS class_ {"
+      " name { cpp_name: 'hashes_other::ComparedOnly' }"
+      "   members {"
+      "     decltype: FUNC func { name { cpp_name: 'Method' } }"
+      "   }"
+      " }";
+  TestMatch(decl_proto, &decl);
+  EXPECT_TRUE(decl.class_().cpp_has_eq());
+  EXPECT_FALSE(decl.class_().has_cpp_hasher());
+  // Its operator== is not const.
+  decl_proto =
+      "decltype: CLASS class_ {"
+      " name { cpp_name: 'OperatorClass' }"
+      " }";
+  TestMatch(decl_proto, &decl);
+  EXPECT_FALSE(decl.class_().cpp_has_eq());
+  EXPECT_FALSE(decl.class_().cpp_has_lt());
+  EXPECT_FALSE(decl.class_().has_cpp_hasher());
+}
+
 }  // namespace clif
@@ -437,6 +437,44 @@ class OperatorClass {
 int operator*(const OperatorClass&);
 int operator*(int, const OperatorClass&);
 
+// Value types for ClassDecl.cpp_has_eq, cpp_has_lt and cpp_hasher.
+class HashableByStd {
+ public:
+  void Method();
+  bool operator==(const HashableByStd& other) const;
+};
+
+namespace std {
+template <typename T> struct hash;
+template <> struct hash<HashableByStd> {
+  unsigned long operator()(const HashableByStd& x) const;  // NOLINT
+};
+}  // namespace std
+
+namespace hashable {
+class OrderedByAbsl {
+ public:
+  void Method();
+  friend bool operator==(const OrderedByAbsl& a, const OrderedByAbsl& b);
+  friend bool operator<(const OrderedByAbsl& a, const OrderedByAbsl& b);
+  template <typename H>
+  friend H AbslHashValue(H h, const OrderedByAbsl& x);
+};
+}  // namespace hashable
+
+namespace hashes_other {
+class Hashed {};
+template <typename H>
+H AbslHashValue(H h, const Hashed& x);
+
+// Argument-dependent lookup finds the AbslHashValue of Hashed.
+class ComparedOnly {
+ public:
+  void Method();
+  bool operator==(const ComparedOnly& other) const;
+};
+}  // namespace hashes_other
+
 class OperatorClass2 {
   int operator*() const { return 1; }
 };
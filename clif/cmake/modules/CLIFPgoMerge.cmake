@@ -0,0 +1,49 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Script run by the clif_pgo_train target (see CLIFUtils.cmake). Expects
+# -DPROFILE_DIR, -DPROFDATA and -DLLVM_PROFDATA.
+#
+# With -DCLEAN=ON it runs before the training runs and removes the profiles of
+# earlier runs, which would otherwise be merged too. Otherwise it runs after
+# them: Clang writes one .profraw file per instrumented process which must be
+# merged with llvm-profdata. GCC updates its .gcda files in place, there is
+# nothing to merge.
+
+file(GLOB_RECURSE profraw_files "${PROFILE_DIR}/*.profraw")
+file(GLOB_RECURSE gcda_files "${PROFILE_DIR}/*.gcda")
+
+if(CLEAN)
+  if(profraw_files OR gcda_files)
+    file(REMOVE ${profraw_files} ${gcda_files})
+  endif()
+  return()
+endif()
+
+if(profraw_files)
+  execute_process(
+    COMMAND ${LLVM_PROFDATA} merge -output=${PROFDATA} ${profraw_files}
+    RESULT_VARIABLE merge_result
+  )
+  if(NOT merge_result EQUAL 0)
+    message(FATAL_ERROR "llvm-profdata merge failed: ${merge_result}")
+  endif()
+  message(STATUS "Merged CLIF PGO profiles into ${PROFDATA}")
+elseif(gcda_files)
+  message(STATUS "CLIF PGO profiles are in ${PROFILE_DIR}")
+else()
+  message(FATAL_ERROR
+    "No CLIF PGO profiles found in ${PROFILE_DIR}. "
+    "Were the instrumented modules exercised by a training run?")
+endif()
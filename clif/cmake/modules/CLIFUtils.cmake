@@ -156,6 +156,96 @@ function(add_clif_test_cc_library name)
   )
 endfunction(add_clif_test_cc_library)
 
+# Profile-guided optimization of the CLIF runtime and generated extension
+# modules. PGO is a two step build driven by the CLIF_PGO cache variable:
+#
+#   1. Configure with -DCLIF_PGO=GENERATE and build the wanted pyclif libraries
+#      followed by the "clif_pgo_train" target. The runtime and all modules are
+#      instrumented, the raw profiles of earlier runs are removed, every
+#      script registered with add_pyclif_pgo_training is run, and their raw
+#      profiles are merged into CLIF_PGO_PROFILE_DIR.
+#   2. Reconfigure the same build directory with -DCLIF_PGO=USE and rebuild.
+#      Objects are now optimized with the merged profiles.
+#
+# Both GCC and Clang are supported. Clang profiles are merged with
+# llvm-profdata, GCC reads its .gcda files from CLIF_PGO_PROFILE_DIR directly.
+set(CLIF_PGO "" CACHE STRING
+  "Profile-guided optimization step for CLIF modules: GENERATE, USE or empty")
+set_property(CACHE CLIF_PGO PROPERTY STRINGS "" GENERATE USE)
+set(CLIF_PGO_PROFILE_DIR "${CMAKE_BINARY_DIR}/clif_pgo" CACHE PATH
+  "Directory holding the CLIF PGO training profiles")
+set(CLIF_PGO_MERGE_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/CLIFPgoMerge.cmake")
+
+if(CLIF_PGO AND NOT CLIF_PGO MATCHES "^(GENERATE|USE)$")
+  message(FATAL_ERROR "CLIF_PGO must be GENERATE, USE or empty, not ${CLIF_PGO}")
+endif()
+
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+  set(CLIF_PGO_PROFDATA "${CLIF_PGO_PROFILE_DIR}/clif.profdata")
+  set(CLIF_PGO_GENERATE_FLAGS "-fprofile-generate=${CLIF_PGO_PROFILE_DIR}")
+  set(CLIF_PGO_USE_FLAGS
+    "-fprofile-use=${CLIF_PGO_PROFDATA} -Wno-profile-instr-unprofiled")
+  find_program(LLVM_PROFDATA llvm-profdata HINTS ${LLVM_TOOLS_BINARY_DIR})
+  if(CLIF_PGO STREQUAL "GENERATE" AND NOT LLVM_PROFDATA)
+    message(FATAL_ERROR "CLIF_PGO with Clang requires llvm-profdata.")
+  endif()
+elseif(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+  set(CLIF_PGO_GENERATE_FLAGS "-fprofile-generate -fprofile-dir=${CLIF_PGO_PROFILE_DIR}")
+  set(CLIF_PGO_USE_FLAGS
+    "-fprofile-use -fprofile-dir=${CLIF_PGO_PROFILE_DIR} -fprofile-correction -Wno-missing-profile")
+elseif(CLIF_PGO)
+  message(FATAL_ERROR "CLIF_PGO is not supported for ${CMAKE_CXX_COMPILER_ID}.")
+endif()
+
+if(CLIF_PGO STREQUAL "GENERATE")
+  file(MAKE_DIRECTORY "${CLIF_PGO_PROFILE_DIR}")
+  # Removes the profiles of earlier runs, before any training script.
+  add_custom_target(clif_pgo_clean
+    COMMAND ${CMAKE_COMMAND}
+            "-DPROFILE_DIR=${CLIF_PGO_PROFILE_DIR}"
+            -DCLEAN=ON
+            -P ${CLIF_PGO_MERGE_SCRIPT}
+  )
+  # Runs all training scripts, then merges their profiles.
+  add_custom_target(clif_pgo_train
+    COMMAND ${CMAKE_COMMAND}
+            "-DPROFILE_DIR=${CLIF_PGO_PROFILE_DIR}"
+            "-DPROFDATA=${CLIF_PGO_PROFDATA}"
+            "-DLLVM_PROFDATA=${LLVM_PROFDATA}"
+            -P ${CLIF_PGO_MERGE_SCRIPT}
+  )
+endif()
+
+# Add the compile and link flags for the current CLIF_PGO step to target.
+# Applied to the CLIF runtime and to every pyclif library.
+function(clif_target_pgo_options target)
+  if(CLIF_PGO STREQUAL "GENERATE")
+    set(pgo_flags "${CLIF_PGO_GENERATE_FLAGS}")
+  elseif(CLIF_PGO STREQUAL "USE")
+    set(pgo_flags "${CLIF_PGO_USE_FLAGS}")
+  else()
+    return()
+  endif()
+  separate_arguments(pgo_compile_options UNIX_COMMAND "${pgo_flags}")
+  target_compile_options(${target} PRIVATE ${pgo_compile_options})
+  # target_link_options needs CMake 3.13, and target_link_libraries cannot be
+  # used as callers mix its plain and keyword signatures.
+  set_property(TARGET ${target} APPEND_STRING PROPERTY LINK_FLAGS " ${pgo_flags}")
+endfunction(clif_target_pgo_options)
+
+# USDT probes (see clif/python/probes.h) in the CLIF runtime and in every
+# pyclif library with -DCLIF_USDT_PROBES=ON. Needs <sys/sdt.h> (systemtap-sdt
+# development package), without it the probes compile to nothing. The wrapper
+# functions are exported under their Python qualnames either way.
+option(CLIF_USDT_PROBES "Add USDT probes to the CLIF runtime and modules" OFF)
+if(CLIF_USDT_PROBES)
+  add_definitions(-DCLIF_USDT_PROBES)
+endif()
+
+# Time the initialization steps of every pyclif library, reported by
+# python -X importtime (see ImportTimer in clif/python/runtime.h).
+option(CLIF_IMPORTTIME "Report pyclif module init steps with -X importtime" OFF)
+
 set(PYCLIF_CC_LIBRARY_PREFIX "py_clif_cc_")
 
 # Function to set up rules to invoke pyclif on a .clif file and build
@@ -172,28 +262,90 @@ set(PYCLIF_CC_LIBRARY_PREFIX "py_clif_cc_")
 #     [CLIF_DEPS name1 [name2...]]  # List of other pyclif_library deps.
 #     [CXX_FLAGS flag1 [flag2...]]  # Compile flags to be passed to clif-matcher
 #     [PROTO_DEPS target1 [target2...]]  # List of pyclif_proto_library deps.
+#     [C_API]  # Export a C-API PyCapsule, see clif/python/capi.h.
+#     [CYTHON_PXD]  # Also write MODULE.pxd for Cython (implies C_API).
+#     [INTEROP]  # Share objects with pybind11 modules, see python/interop.h.
+#     [LAZY_TYPES]  # Build class types on first use, not at import.
 #   )
+# Let CMake make pyclif depfile paths relative to the top build directory for
+# Ninja, see add_pyclif_library.
+if(POLICY CMP0116)
+  cmake_policy(SET CMP0116 NEW)
+endif()
+
 function(add_pyclif_library name pyclif_file)
-  cmake_parse_arguments(PYCLIF_LIBRARY "" "" "CC_DEPS;CLIF_DEPS;CXX_FLAGS;PROTO_DEPS" ${ARGN})
+  cmake_parse_arguments(PYCLIF_LIBRARY "C_API;CYTHON_PXD;INTEROP;LAZY_TYPES" "" "CC_DEPS;CLIF_DEPS;CXX_FLAGS;PROTO_DEPS" ${ARGN})
 
   string(REPLACE ".clif" "" pyclif_file_basename ${pyclif_file})
   set(gen_cc "${CMAKE_CURRENT_BINARY_DIR}/${pyclif_file_basename}.cc")
   set(gen_h "${CMAKE_CURRENT_BINARY_DIR}/${pyclif_file_basename}_clif.h")
   set(gen_init "${CMAKE_CURRENT_BINARY_DIR}/${pyclif_file_basename}.init.cc")
+  set(gen_dep "${CMAKE_CURRENT_BINARY_DIR}/${pyclif_file_basename}.d")
 
   clif_extension_module_name(${name} module_name)
+  # The extension module is module_dir/module_basename.so, importable as
+  # module_name.
+  set(module_dir "${CMAKE_CURRENT_BINARY_DIR}")
+  string(REGEX REPLACE "^.*\\." "" module_basename "${module_name}")
+
+  # pyclif writes a depfile listing every .clif and C++ header read while
+  # parsing and matching, so that editing any of them regenerates the wrapper.
+  # Ninja always supports DEPFILE, Makefile generators only from CMake 3.20.
+  # From 3.20 (CMP0116) CMake rewrites the paths for Ninja; before, Ninja reads
+  # the depfile verbatim and its target must be the output path as written in
+  # build.ninja, relative to the top build directory.
+  if(CMAKE_GENERATOR MATCHES "Ninja|Makefiles" AND
+     NOT CMAKE_VERSION VERSION_LESS 3.20)
+    set(pyclif_depfile_args DEPFILE ${gen_dep})
+    set(pyclif_depfile_flags --depfile_out=${gen_dep})
+  elseif(CMAKE_GENERATOR MATCHES "Ninja")
+    file(RELATIVE_PATH gen_cc_from_top ${CMAKE_BINARY_DIR} ${gen_cc})
+    set(pyclif_depfile_args DEPFILE ${gen_dep})
+    set(pyclif_depfile_flags --depfile_out=${gen_dep}
+                             --depfile_target=${gen_cc_from_top})
+  else()
+    set(pyclif_depfile_args)
+    set(pyclif_depfile_flags)
+  endif()
+
+  # C_API exports a PyCapsule with C++ entry points for other extensions.
+  if(PYCLIF_LIBRARY_C_API)
+    set(pyclif_c_api_args --c_api)
+  else()
+    set(pyclif_c_api_args)
+  endif()
+  if(PYCLIF_LIBRARY_INTEROP)
+    list(APPEND pyclif_c_api_args --interop)
+  endif()
+  if(PYCLIF_LIBRARY_LAZY_TYPES)
+    list(APPEND pyclif_c_api_args --lazy_types)
+  endif()
+  if(CLIF_USDT_PROBES)
+    list(APPEND pyclif_c_api_args --probes)
+  endif()
+  if(CLIF_IMPORTTIME)
+    list(APPEND pyclif_c_api_args --importtime)
+  endif()
+  set(gen_pxd)
+  if(PYCLIF_LIBRARY_CYTHON_PXD)
+    # Cython looks up "cimport pkg.mod" in pkg/mod.pxd, next to the module.
+    set(gen_pxd "${module_dir}/${module_basename}.pxd")
+    list(APPEND pyclif_c_api_args --pxd_out=${gen_pxd})
+  endif()
 
   if (GOOGLE_PROTOBUF_INCLUDE_DIRS)
     set(GOOGLE_PROTOBUF_CXX_FLAGS "-I${GOOGLE_PROTOBUF_INCLUDE_DIRS}")
   endif(GOOGLE_PROTOBUF_INCLUDE_DIRS)
 
   add_custom_command(
-    OUTPUT ${gen_cc} ${gen_h} ${gen_init}
+    OUTPUT ${gen_cc} ${gen_h} ${gen_init} ${gen_pxd}
     COMMAND
       # List LLVM_TOOLS_BIN_DIR before LLVM_TOOLS_DIR in PYTHONPATH as we
       # want to first load the __init__.py in LLVM_TOOLS_BIN_DIR.
       "PYTHONPATH=${CLIF_BIN_DIR}:${CLIF_SRC_DIR}" ${PYTHON_EXECUTABLE} ${PYCLIF}
       -p${CLIF_PYTHON_DIR}/types.h -c${gen_cc} -g${gen_h} -i${gen_init}
+      ${pyclif_depfile_flags}
+      ${pyclif_c_api_args}
       -I${CLIF_SRC_DIR} -I${CLIF_BIN_DIR}
       --modname=${module_name}
       --matcher_bin=${CLIF_MATCHER}
@@ -203,6 +355,8 @@ function(add_pyclif_library name pyclif_file)
     # This step invokes the clif-matcher. Hence, we need it to be built before
     # we can invoke it.
     DEPENDS clif-matcher ${PYCLIF_LIBRARY_CLIF_DEPS} ${PYCLIF_LIBRARY_PROTO_DEPS}
+            ${CMAKE_CURRENT_SOURCE_DIR}/${pyclif_file}
+    ${pyclif_depfile_args}
   )
 
   clif_target_name(${name} lib_target_name)
@@ -218,8 +372,8 @@ function(add_pyclif_library name pyclif_file)
 
   set_target_properties(${lib_target_name}
     PROPERTIES
-      LIBRARY_OUTPUT_NAME ${name}
-      LIBRARY_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+      LIBRARY_OUTPUT_NAME ${module_basename}
+      LIBRARY_OUTPUT_DIRECTORY ${module_dir}
       # We do not want any prefix like "lib" to be added to the library file.
       PREFIX ""
   )
@@ -247,9 +401,12 @@ function(add_pyclif_library name pyclif_file)
     pyClifRuntime
     ${PYTHON_LIBRARIES}
 
+    absl::hash
     absl::memory
     absl::optional
   )
+
+  clif_target_pgo_options(${lib_target_name})
 endfunction(add_pyclif_library)
 
 function(add_pyclif_proto_library name proto_file proto_lib)
@@ -302,6 +459,9 @@ function(add_pyclif_proto_library name proto_file proto_lib)
 
   target_link_libraries(${name} ${PYCLIF_PROTO_LINK_LIBRARIES})
   target_link_libraries(${name}Shared ${PYCLIF_PROTO_LINK_LIBRARIES})
+
+  clif_target_pgo_options(${name})
+  clif_target_pgo_options(${name}Shared)
 endfunction(add_pyclif_proto_library name proto_file)
 
 function(add_pyclif_library_and_test name)
@@ -318,6 +478,36 @@ function(add_pyclif_library_and_test name)
   )
 endfunction(add_pyclif_library_and_test)
 
+# Function to register a PGO training run. It is a no-op unless CLIF_PGO is
+# GENERATE, in which case the instrumented modules in DEPENDS are built and
+# "${PYTHON_EXECUTABLE} PYTHON_ARGS" is run as part of the clif_pgo_train
+# target. Training may be any Python workload: a user script or a unittest
+# suite.
+#
+# Usage:
+#   add_pyclif_pgo_training(
+#     NAME
+#     PYTHON_ARGS arg1 [arg2...]  # E.g. path/to/train.py --iterations=100
+#     [DEPENDS target1 [target2...]]  # pyclif libraries exercised by training.
+#   )
+function(add_pyclif_pgo_training name)
+  cmake_parse_arguments(PGO_TRAINING "" "" "PYTHON_ARGS;DEPENDS" ${ARGN})
+  if(NOT CLIF_PGO STREQUAL "GENERATE")
+    return()
+  endif()
+
+  clif_target_name(${name} training_target_name)
+
+  add_custom_target("${training_target_name}_pgo_training"
+    COMMAND "PYTHONPATH=${CLIF_BIN_DIR}" ${PYTHON_EXECUTABLE} ${PGO_TRAINING_PYTHON_ARGS}
+    WORKING_DIRECTORY ${CLIF_BIN_DIR}
+  )
+  add_dependencies("${training_target_name}_pgo_training"
+    clif_pgo_clean ${PGO_TRAINING_DEPENDS}
+  )
+  add_dependencies(clif_pgo_train "${training_target_name}_pgo_training")
+endfunction(add_pyclif_pgo_training)
+
 
 # Function to set up rules to copy python file to build directory.
 #
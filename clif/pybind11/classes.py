@@ -13,6 +13,7 @@
 # limitations under the License.
 """Generates pybind11 bindings code for classes."""
 
+import re
 from typing import Generator
 
 from clif.protos import ast_pb2
@@ -24,6 +25,10 @@ from clif.pybind11 import variables
 
 I = utils.I
 
+_CONTAINER_TEMPLATE = re.compile(r'(?:::)?([\w:]+?)\s*<')
+_VECTOR_TEMPLATES = ('std::vector', 'std::deque')
+_MAP_TEMPLATES = ('std::map', 'std::unordered_map')
+
 
 def generate_from(
     class_decl: ast_pb2.ClassDecl, superclass_name: str,
@@ -40,25 +45,15 @@ def generate_from(
   """
   yield I + '{'
   class_name = f'{class_decl.name.native}_class'
-  definition = f'py::classh<{class_decl.name.cpp_name}'
-  if not class_decl.suppress_upcasts:
-    for base in class_decl.bases:
-      if base.HasField('cpp_name'):
-        definition += f', {base.cpp_name}'
-  if python_override_class_name:
-    definition += f', {python_override_class_name}'
-  definition += (f'> {class_name}({superclass_name}, '
-                 f'"{class_decl.name.native}"')
-  if class_decl.HasField('docstring'):
-    definition += f', {_as_cpp_string_literal(class_decl.docstring)}'
-  if class_decl.enable_instance_dict:
-    definition += ', py::dynamic_attr()'
-  if class_decl.final:
-    definition += ', py::is_final()'
-  definition += ');'
-  yield I + I + definition
-
-  constructor_defined = False
+  if class_decl.opaque_container:
+    yield I + I + _generate_opaque_container(class_name, class_decl,
+                                             superclass_name)
+  else:
+    yield I + I + _generate_class(class_name, class_decl, superclass_name,
+                                  python_override_class_name)
+
+  # py::bind_vector and py::bind_map define the default constructor.
+  constructor_defined = class_decl.opaque_container
   trampoline_generated = False
   for member in class_decl.members:
     if member.decltype == ast_pb2.Decl.Type.CONST:
@@ -88,9 +83,51 @@ def generate_from(
   if (not constructor_defined and class_decl.cpp_has_def_ctor and
       (not class_decl.cpp_abstract or trampoline_generated)):
     yield I + I + f'{class_name}.def(py::init<>());'
+  if not class_decl.opaque_container:
+    yield I + I + f'DefClifInterop({class_name});'
   yield I + '}'
 
 
+def _generate_class(class_name: str, class_decl: ast_pb2.ClassDecl,
+                    superclass_name: str,
+                    python_override_class_name: str) -> str:
+  """Generates the py::classh<> definition."""
+  definition = f'py::classh<{class_decl.name.cpp_name}'
+  if not class_decl.suppress_upcasts:
+    for base in class_decl.bases:
+      if base.HasField('cpp_name'):
+        definition += f', {base.cpp_name}'
+  if python_override_class_name:
+    definition += f', {python_override_class_name}'
+  definition += (f'> {class_name}({superclass_name}, '
+                 f'"{class_decl.name.native}"')
+  if class_decl.HasField('docstring'):
+    definition += f', {_as_cpp_string_literal(class_decl.docstring)}'
+  if class_decl.enable_instance_dict:
+    definition += ', py::dynamic_attr()'
+  if class_decl.final:
+    definition += ', py::is_final()'
+  return definition + ');'
+
+
+def _generate_opaque_container(class_name: str,
+                               class_decl: ast_pb2.ClassDecl,
+                               superclass_name: str) -> str:
+  """Generates the py::bind_vector<> or py::bind_map<> definition."""
+  template = _CONTAINER_TEMPLATE.match(class_decl.name.cpp_name)
+  if template and template.group(1) in _VECTOR_TEMPLATES:
+    bind = 'py::bind_vector'
+  elif template and template.group(1) in _MAP_TEMPLATES:
+    bind = 'py::bind_map'
+  else:
+    raise ValueError(
+        f'@opaque_container class {class_decl.name.native} must wrap one of'
+        f' {", ".join(sorted(_VECTOR_TEMPLATES + _MAP_TEMPLATES))},'
+        f' got {class_decl.name.cpp_name}')
+  return (f'auto {class_name} = {bind}<{class_decl.name.cpp_name}>('
+          f'{superclass_name}, "{class_decl.name.native}");')
+
+
 def _generate_constructor(
     class_name: str, func_decl: ast_pb2.FuncDecl,
     class_decl: ast_pb2.ClassDecl) -> Generator[str, None, None]:
@@ -100,14 +137,17 @@ def _generate_constructor(
   params = ', '.join([f'{p.name.cpp_name}' for p in func_decl.params])
   cpp_types = ', '.join(
       [f'{function_lib.generate_param_type(p)}' for p in func_decl.params])
+  # pybind11 initializes the instance holder inside py::init, which needs the
+  # GIL, so __init__ keeps it.
+  init_suffixes = function_lib.generate_function_suffixes(
+      func_decl, release_gil=False)
   if func_decl.name.native == '__init__' and func_decl.is_extend_method:
     yield f'{class_name}.def(py::init([]({params_with_types}) {{'
     yield I + f'return {func_decl.name.cpp_name}({params});'
-    yield f'}}), {function_lib.generate_function_suffixes(func_decl)}'
+    yield f'}}), {init_suffixes}'
 
   elif func_decl.name.native == '__init__':
-    yield (f'{class_name}.def(py::init<{cpp_types}>(), '
-           f'{function_lib.generate_function_suffixes(func_decl)}')
+    yield f'{class_name}.def(py::init<{cpp_types}>(), {init_suffixes}'
 
   elif func_decl.constructor:
     yield (f'{class_name}.def_static("{func_decl.name.native}", '
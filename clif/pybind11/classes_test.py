@@ -0,0 +1,114 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Tests for clif.pybind11.classes."""
+
+from absl.testing import absltest
+from clif.protos import ast_pb2
+from clif.pybind11 import classes
+from clif.pybind11 import generator
+
+
+def _opaque_container_decl(native, cpp_name):
+  decl = ast_pb2.Decl()
+  decl.decltype = ast_pb2.Decl.Type.CLASS
+  decl.cpp_file = 'foo.h'
+  decl.class_.name.native = native
+  decl.class_.name.cpp_name = cpp_name
+  decl.class_.opaque_container = True
+  decl.class_.cpp_has_def_ctor = True
+  return decl
+
+
+class OpaqueContainerTest(absltest.TestCase):
+
+  def test_bind_vector(self):
+    decl = _opaque_container_decl('Ints', '::std::vector<int>')
+    self.assertEqual(list(classes.generate_from(decl.class_, 'm', '')), [
+        '  {',
+        '    auto Ints_class = py::bind_vector<::std::vector<int>>(m, "Ints");',
+        '  }',
+    ])
+
+  def test_bind_map(self):
+    decl = _opaque_container_decl('Counts',
+                                  '::std::unordered_map<::std::string, int>')
+    self.assertEqual(list(classes.generate_from(decl.class_, 'm', '')), [
+        '  {',
+        '    auto Counts_class = py::bind_map<'
+        '::std::unordered_map<::std::string, int>>(m, "Counts");',
+        '  }',
+    ])
+
+  def test_unsupported_container(self):
+    decl = _opaque_container_decl('IntSet', '::std::set<int>')
+    with self.assertRaisesRegex(ValueError, 'IntSet must wrap one of'):
+      list(classes.generate_from(decl.class_, 'm', ''))
+
+  def test_make_opaque_in_header(self):
+    ast = ast_pb2.AST()
+    ast.decls.append(_opaque_container_decl('Ints', '::std::vector<int>'))
+    module = generator.ModuleGenerator(ast, 'pkg.mod', 'mod.h', [])
+    module.register_types(ast)
+    header = list(module.generate_header(ast))
+    self.assertIn('PYBIND11_MAKE_OPAQUE(::std::vector<int>)', header)
+    self.assertNotIn(
+        'PYBIND11_SMART_HOLDER_TYPE_CASTERS(::std::vector<int>)', header)
+
+
+class ConstructorTest(absltest.TestCase):
+
+  def _generate(self, ctor):
+    decl = ast_pb2.Decl()
+    decl.decltype = ast_pb2.Decl.Type.CLASS
+    decl.class_.name.native = 'Point'
+    decl.class_.name.cpp_name = '::Point'
+    member = decl.class_.members.add()
+    member.decltype = ast_pb2.Decl.Type.FUNC
+    member.func.CopyFrom(ctor)
+    return '\n'.join(classes.generate_from(decl.class_, 'm', ''))
+
+  def _ctor(self, native):
+    ctor = ast_pb2.FuncDecl()
+    ctor.name.native = native
+    ctor.name.cpp_name = 'Point'
+    ctor.constructor = True
+    param = ctor.params.add()
+    param.name.native = param.name.cpp_name = 'x'
+    param.type.lang_type = 'int'
+    param.type.cpp_type = param.cpp_exact_type = 'int'
+    return ctor
+
+  def test_init_keeps_gil(self):
+    code = self._generate(self._ctor('__init__'))
+    self.assertIn(
+        'Point_class.def(py::init<int>(), py::arg("x"), '
+        'py::return_value_policy::automatic);', code)
+    self.assertNotIn('gil_scoped_release', code)
+
+  def test_extend_init_keeps_gil(self):
+    ctor = self._ctor('__init__')
+    ctor.is_extend_method = True
+    code = self._generate(ctor)
+    self.assertIn('Point_class.def(py::init([](int x) {', code)
+    self.assertNotIn('gil_scoped_release', code)
+
+  def test_static_constructor_releases_gil(self):
+    code = self._generate(self._ctor('FromInt'))
+    self.assertIn(
+        '}, py::arg("x"), py::return_value_policy::automatic, '
+        'py::call_guard<py::gil_scoped_release>());', code)
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -19,14 +19,32 @@ from typing import Optional
 from clif.protos import ast_pb2
 from clif.pybind11 import utils
 
+# Like the C API backend, release the GIL while running the C++ code.
+# Arguments are converted before and the return value after the call, with the
+# GIL held. Python callbacks and virtual overrides reacquire it: pybind11's
+# std::function caster and PYBIND11_OVERRIDE use py::gil_scoped_acquire.
+GIL_RELEASE_CALL_GUARD = 'py::call_guard<py::gil_scoped_release>()'
 
-def generate_function_suffixes(func_decl: ast_pb2.FuncDecl) -> str:
-  """Generates py_args, docstrings and return value policys."""
+
+def generate_function_suffixes(func_decl: ast_pb2.FuncDecl,
+                               release_gil: bool = True) -> str:
+  """Generates py_args, docstrings, return value policys and call guards.
+
+  Args:
+    func_decl: Function declaration in proto format.
+    release_gil: Release the GIL around the call unless the function has
+      py_keep_gil set. Pass False if the bound callable releases it itself.
+
+  Returns:
+    The arguments of the .def() call after the bound callable.
+  """
   py_args = generate_py_args(func_decl)
   suffix = ''
   if py_args:
     suffix += f'{py_args}, '
   suffix += f'{generate_return_value_policy(func_decl)}'
+  if release_gil and not func_decl.py_keep_gil:
+    suffix += f', {GIL_RELEASE_CALL_GUARD}'
   if func_decl.docstring:
     suffix += f', {generate_docstring(func_decl)}'
   suffix += ');'
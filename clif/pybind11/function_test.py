@@ -0,0 +1,114 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Tests for GIL handling in clif.pybind11.function."""
+
+from absl.testing import absltest
+from google.protobuf import text_format
+from clif.protos import ast_pb2
+from clif.pybind11 import function
+
+_CALL_GUARD = 'py::call_guard<py::gil_scoped_release>()'
+
+
+def _func_decl(proto):
+  decl = ast_pb2.FuncDecl()
+  text_format.Parse(proto, decl)
+  return decl
+
+
+def _generate(proto, class_decl=None):
+  return '\n'.join(function.generate_from('m', _func_decl(proto), class_decl))
+
+
+class GilReleaseTest(absltest.TestCase):
+
+  def test_def_releases_gil(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      params { name { native: "x" cpp_name: "x" }
+               type { lang_type: "int" cpp_type: "int" } cpp_exact_type: "int" }
+      cpp_void_return: true
+      cpp_num_params: 1
+    """)
+    self.assertEqual(code, '\n'.join([
+        'm.def("f",',
+        '  (void (*)(int))',
+        '  &f,',
+        '  py::arg("x"), py::return_value_policy::automatic, '
+        f'{_CALL_GUARD});',
+    ]))
+
+  def test_def_keeps_gil(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      cpp_void_return: true
+      py_keep_gil: true
+    """)
+    self.assertNotIn(_CALL_GUARD, code)
+    self.assertIn('py::return_value_policy::automatic);', code)
+
+  def test_operator_releases_gil(self):
+    class_decl = ast_pb2.ClassDecl()
+    class_decl.name.cpp_name = '::Point'
+    code = _generate("""
+      name { native: "__neg__" cpp_name: "::Point::operator-" }
+      returns { type { lang_type: "Point" cpp_type: "::Point" }
+                cpp_exact_type: "::Point" }
+    """, class_decl)
+    self.assertEqual(code, f'm.def(~(py::self), {_CALL_GUARD});')
+
+  def test_operator_keeps_gil(self):
+    class_decl = ast_pb2.ClassDecl()
+    class_decl.name.cpp_name = '::Point'
+    code = _generate("""
+      name { native: "__add__" cpp_name: "::Point::operator+" }
+      params { name { native: "other" cpp_name: "other" }
+               type { lang_type: "Point" cpp_type: "::Point" }
+               cpp_exact_type: "const ::Point &" }
+      returns { type { lang_type: "Point" cpp_type: "::Point" }
+                cpp_exact_type: "::Point" }
+      cpp_num_params: 1
+      py_keep_gil: true
+    """, class_decl)
+    self.assertEqual(code, 'm.def(py::self + py::self);')
+
+  def test_lambda_releases_gil_around_call_only(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      params { name { native: "o" cpp_name: "o" }
+               type { lang_type: "object" cpp_type: "PyObject *" }
+               cpp_exact_type: "::PyObject *" }
+      cpp_void_return: true
+      cpp_num_params: 1
+    """)
+    self.assertIn('py::gil_scoped_release gil_release;', code)
+    self.assertNotIn(_CALL_GUARD, code)
+
+  def test_lambda_with_object_param_keeps_gil(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      params { name { native: "o" cpp_name: "o" }
+               type { lang_type: "object" cpp_type: "PyObject *" }
+               cpp_exact_type: "::PyObject *" }
+      cpp_void_return: true
+      cpp_num_params: 1
+      py_keep_gil: true
+    """)
+    self.assertIn('\n  f(o.ptr());\n', code)
+    self.assertNotIn('gil_scoped_release', code)
+    self.assertNotIn(_CALL_GUARD, code)
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -80,6 +80,15 @@ class ClassType(BaseType):
     yield ''
 
 
+@dataclasses.dataclass
+class OpaqueContainerType(ClassType):
+  """Wraps a std container bound with py::bind_vector or py::bind_map."""
+
+  def generate_type_caster(self) -> Generator[str, None, None]:
+    # Replaces the copying stl.h caster, must precede any use of the type.
+    yield f'PYBIND11_MAKE_OPAQUE({self.cpp_name})'
+
+
 @dataclasses.dataclass
 class EnumType(BaseType):
   """Wraps a C++ Enum."""
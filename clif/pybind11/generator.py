@@ -155,6 +155,7 @@ class ModuleGenerator(object):
     yield '#include "third_party/pybind11/include/pybind11/smart_holder.h"'
     yield '// potential future optimization: generate this line only as needed.'
     yield '#include "third_party/pybind11/include/pybind11/stl.h"'
+    yield '#include "third_party/pybind11/include/pybind11/stl_bind.h"'
     yield ''
     yield '#include "clif/pybind11/runtime.h"'
     yield '#include "clif/pybind11/type_casters.h"'
@@ -254,7 +255,11 @@ class ModuleGenerator(object):
       py_name = decl.class_.name.native
       if parent_py_name:
         py_name = '.'.join([parent_py_name, py_name])
-      class_type = gen_type_info.ClassType(
+      if decl.class_.opaque_container:
+        type_info = gen_type_info.OpaqueContainerType
+      else:
+        type_info = gen_type_info.ClassType
+      class_type = type_info(
           cpp_name=decl.class_.name.cpp_name, py_name=py_name,
           cpp_namespace=cpp_namespace)
       self._types.append(class_type)
@@ -23,6 +23,7 @@ from clif.pybind11 import utils
 I = utils.I
 
 _STATUS_PATTERNS = (r'::absl::Status', r'::absl::StatusOr<(\S)+>')
+_SCALAR_LANG_TYPES = frozenset(('int', 'float', 'bool', 'complex'))
 
 
 def generate_lambda(
@@ -32,10 +33,16 @@ def generate_lambda(
   """Entry point for generation of lambda functions in pybind11."""
   params_with_type = _generate_lambda_params_with_types(func_decl, class_decl)
   func_name = func_decl.name.native.rstrip('#')  # @sequential
+  trailing_return = ''
+  if _returns_call_result(func_decl):
+    trailing_return = f' -> {_generate_return_type(func_decl.returns[0])}'
   yield (f'{module_name}.{function_lib.generate_def(func_decl)}'
-         f'("{func_name}", []({params_with_type}) {{')
+         f'("{func_name}", []({params_with_type}){trailing_return} {{')
   yield from _generate_lambda_body(func_decl, class_decl)
-  yield f'}}, {function_lib.generate_function_suffixes(func_decl)}'
+  # The lambda body releases the GIL only around the C++ call.
+  suffixes = function_lib.generate_function_suffixes(
+      func_decl, release_gil=False)
+  yield f'}}, {suffixes}'
 
 
 def _generate_lambda_body(
@@ -46,26 +53,41 @@ def _generate_lambda_body(
   function_call = _generate_function_call(func_decl, class_decl)
   function_call_params = _generate_function_call_params(func_decl, class_decl)
   function_call_returns = _generate_function_call_returns(func_decl)
+  call = f'{function_call}({function_call_params})'
+  has_return_value = bool(not func_decl.cpp_void_return and func_decl.returns)
+  if has_return_value and func_decl.returns[0].type.lang_type == 'object':
+    call = f'ConvertPyObject({call})'
 
-  # Generates declarations of return values
+  # Generates declarations of output parameters
   for i, r in enumerate(func_decl.returns):
-    if r.type.lang_type == 'object':
-      yield I + f'py::object ret{i}{{}};'
-    elif _is_status_param(r):
-      yield (I +
-             f'pybind11::google::PyCLIFStatus<{r.cpp_exact_type}> ret{i}{{}};')
-    else:
-      yield I + f'{r.type.cpp_type} ret{i}{{}};'
-
-  # Generates call to the wrapped function
-  if not func_decl.cpp_void_return and len(func_decl.returns):
-    if func_decl.returns[0].type.lang_type == 'object':
-      yield I + ('ret0 = '
-                 f'ConvertPyObject({function_call}({function_call_params}));')
+    if i or not has_return_value:
+      yield I + f'{_generate_return_type(r)} ret{i}{{}};'
+
+  # Generates call to the wrapped function. The return value is initialized
+  # from the call expression, neither default constructed nor assigned.
+  if _returns_call_result(func_decl):
+    if not func_decl.py_keep_gil:
+      # The result is a C++ value, converted by pybind11 with the GIL held.
+      yield I + 'py::gil_scoped_release gil_release;'
+    yield I + f'return {call};'
+    return
+  if has_return_value:
+    ret0 = f'{_generate_return_type(func_decl.returns[0])} ret0 = '
+    if func_decl.py_keep_gil:
+      yield I + f'{ret0}{call};'
     else:
-      yield I + f'ret0 = {function_call}({function_call_params});'
+      # Python objects (bytes, postproc results) are created after the call.
+      yield I + f'{ret0}[&] {{'
+      yield I + I + 'py::gil_scoped_release gil_release;'
+      yield I + I + f'return {call};'
+      yield I + '}();'
+  elif func_decl.py_keep_gil:
+    yield I + f'{call};'
   else:
-    yield I + f'{function_call}({function_call_params});'
+    yield I + '{'
+    yield I + I + 'py::gil_scoped_release gil_release;'
+    yield I + I + f'{call};'
+    yield I + '}'
 
   # Generates returns of the lambda expression
   if func_decl.postproc == '->self':
@@ -73,10 +95,11 @@ def _generate_lambda_body(
   elif func_decl.postproc:
     assert '.' in func_decl.postproc
     module_name, method_name = func_decl.postproc.rsplit('.', maxsplit=1)
-    # TODO: Port or reuse `clif::ImportFQName`.
-    yield I + f'auto mod = py::module_::import("{module_name}");'
-    yield I + ('py::object result = '
-               f'mod.attr("{method_name}")({function_call_returns});')
+    # Imports the postproc on the first call only, see ImportAttrOnce.
+    yield I + ('PYBIND11_CONSTINIT static '
+               'py::gil_safe_call_once_and_store<py::object> postproc;')
+    yield I + ('py::object result = ImportAttrOnce(&postproc, '
+               f'"{module_name}", "{method_name}")({function_call_returns});')
     yield I + 'return result;'
   elif len(func_decl.returns) > 1:
     yield I + f'return std::make_tuple({function_call_returns});'
@@ -84,6 +107,20 @@ def _generate_lambda_body(
     yield I + f'return {function_call_returns};'
 
 
+def _returns_call_result(func_decl: ast_pb2.FuncDecl) -> bool:
+  """The lambda can return the C++ call expression itself."""
+  return (not func_decl.cpp_void_return and len(func_decl.returns) == 1 and
+          not func_decl.postproc and not _has_bytes_return(func_decl))
+
+
+def _generate_return_type(r: ast_pb2.ParamDecl) -> str:
+  if r.type.lang_type == 'object':
+    return 'py::object'
+  elif _is_status_param(r):
+    return f'pybind11::google::PyCLIFStatus<{r.cpp_exact_type}>'
+  return r.type.cpp_type
+
+
 def _generate_function_call_params(
     func_decl: ast_pb2.FuncDecl,
     class_decl: Optional[ast_pb2.ClassDecl] = None) -> str:
@@ -97,6 +134,9 @@ def _generate_function_call_params(
         params_list.append(f'{p.name.cpp_name}.ptr()')
       else:
         params_list.append(f'{p.name.cpp_name}.cast<{p.cpp_exact_type}>()')
+    elif _is_passed_by_value(p):
+      # The lambda owns its by-value parameters, move them into the call.
+      params_list.append(f'std::move({p.name.cpp_name})')
     else:
       params_list.append(f'{p.name.cpp_name}')
 
@@ -121,6 +161,17 @@ def _generate_function_call_params(
     return params
 
 
+def _is_passed_by_value(p: ast_pb2.ParamDecl) -> bool:
+  exact_type = p.cpp_exact_type
+  if not exact_type or not utils.is_usable_cpp_exact_type(exact_type):
+    return False
+  if exact_type.endswith('&&'):
+    return True
+  return (not p.type.cpp_raw_pointer and '&' not in exact_type and
+          '*' not in exact_type and
+          p.type.lang_type not in _SCALAR_LANG_TYPES)
+
+
 def _generate_function_call_returns(func_decl: ast_pb2.FuncDecl) -> str:
   all_returns_list = []
   for i, r in enumerate(func_decl.returns):
@@ -0,0 +1,201 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Tests for clif.pybind11.lambdas."""
+
+from absl.testing import absltest
+from google.protobuf import text_format
+from clif.protos import ast_pb2
+from clif.pybind11 import lambdas
+
+
+def _generate(proto):
+  func_decl = ast_pb2.FuncDecl()
+  text_format.Parse(proto, func_decl)
+  return list(lambdas.generate_lambda('m', func_decl))
+
+
+_PARAM_FOO = """
+  params { name { native: "foo" cpp_name: "foo" }
+           type { lang_type: "Foo" cpp_type: "::Foo" }
+           cpp_exact_type: "::std::unique_ptr<::Foo>" }
+"""
+
+
+class CallResultTest(absltest.TestCase):
+
+  def test_void_return(self):
+    self.assertEqual(_generate("""
+      name { native: "f" cpp_name: "f" }
+      cpp_void_return: true
+    """), [
+        'm.def("f", []() {',
+        '  {',
+        '    py::gil_scoped_release gil_release;',
+        '    f();',
+        '  }',
+        '  return ;',
+        '}, py::return_value_policy::automatic);',
+    ])
+
+  def test_return_by_value(self):
+    self.assertEqual(_generate("""
+      name { native: "f" cpp_name: "f" }
+      returns { type { lang_type: "Foo" cpp_type: "::Foo" }
+                cpp_exact_type: "::Foo" }
+    """), [
+        'm.def("f", []() -> ::Foo {',
+        '  py::gil_scoped_release gil_release;',
+        '  return f();',
+        '}, py::return_value_policy::move);',
+    ])
+
+  def test_return_by_reference(self):
+    self.assertEqual(_generate("""
+      name { native: "f" cpp_name: "f" }
+      returns { type { lang_type: "Foo" cpp_type: "::Foo" }
+                cpp_exact_type: "const ::Foo &" }
+    """), [
+        'm.def("f", []() -> ::Foo {',
+        '  py::gil_scoped_release gil_release;',
+        '  return f();',
+        '}, py::return_value_policy::copy);',
+    ])
+
+  def test_multiple_outputs(self):
+    self.assertEqual(_generate("""
+      name { native: "f" cpp_name: "f" }
+      returns { type { lang_type: "int" cpp_type: "int" }
+                cpp_exact_type: "int" }
+      returns { type { lang_type: "Foo" cpp_type: "::Foo" }
+                cpp_exact_type: "::Foo *" }
+      py_keep_gil: true
+    """), [
+        'm.def("f", []() {',
+        '  ::Foo ret1{};',
+        '  int ret0 = f(&ret1);',
+        '  return std::make_tuple(ret0, ret1);',
+        '}, py::return_value_policy::move);',
+    ])
+
+  def test_output_parameters_only(self):
+    self.assertEqual(_generate("""
+      name { native: "f" cpp_name: "f" }
+      returns { type { lang_type: "Foo" cpp_type: "::Foo" }
+                cpp_exact_type: "::Foo *" }
+      cpp_void_return: true
+      py_keep_gil: true
+    """), [
+        'm.def("f", []() {',
+        '  ::Foo ret0{};',
+        '  f(&ret0);',
+        '  return ret0;',
+        '}, py::return_value_policy::automatic);',
+    ])
+
+  def test_bytes_return(self):
+    self.assertEqual(_generate("""
+      name { native: "f" cpp_name: "f" }
+      returns { type { lang_type: "bytes" cpp_type: "::std::string" }
+                cpp_exact_type: "::std::string" }
+    """), [
+        'm.def("f", []() {',
+        '  ::std::string ret0 = [&] {',
+        '    py::gil_scoped_release gil_release;',
+        '    return f();',
+        '  }();',
+        '  return py::bytes(ret0);',
+        '}, py::return_value_policy::move);',
+    ])
+
+  def test_postproc_return(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      returns { type { lang_type: "int" cpp_type: "int" }
+                cpp_exact_type: "int" }
+      postproc: "clif.python.postproc.ValueErrorOnFalse"
+    """)
+    self.assertEqual(code[:5], [
+        'm.def("f", []() {',
+        '  int ret0 = [&] {',
+        '    py::gil_scoped_release gil_release;',
+        '    return f();',
+        '  }();',
+    ])
+    self.assertEqual(code[-2], '  return result;')
+
+
+class PassedByValueTest(absltest.TestCase):
+
+  def test_unique_ptr_moved_once(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      %s
+      cpp_void_return: true
+      py_keep_gil: true
+    """ % _PARAM_FOO)
+    self.assertEqual(code[1], '  f(std::move(foo));')
+    self.assertLen([s for s in code if 'std::move' in s], 1)
+
+  def test_unique_ptr_moved_into_returned_call(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      %s
+      returns { type { lang_type: "int" cpp_type: "int" }
+                cpp_exact_type: "int" }
+    """ % _PARAM_FOO)
+    self.assertEqual(code[2], '  return f(std::move(foo));')
+    self.assertEqual('\n'.join(code).count('std::move'), 1)
+
+  def test_reference_and_scalar_not_moved(self):
+    code = '\n'.join(_generate("""
+      name { native: "f" cpp_name: "f" }
+      params { name { native: "foo" cpp_name: "foo" }
+               type { lang_type: "Foo" cpp_type: "::Foo" }
+               cpp_exact_type: "const ::Foo &" }
+      params { name { native: "n" cpp_name: "n" }
+               type { lang_type: "int" cpp_type: "int" }
+               cpp_exact_type: "int" }
+      cpp_void_return: true
+      py_keep_gil: true
+    """))
+    self.assertIn('  f(foo, n);', code)
+    self.assertNotIn('std::move', code)
+
+
+class PostprocTest(absltest.TestCase):
+
+  def test_postproc_imported_once(self):
+    code = _generate("""
+      name { native: "f" cpp_name: "f" }
+      returns { type { lang_type: "int" cpp_type: "int" }
+                cpp_exact_type: "int" }
+      postproc: "clif.python.postproc.ValueErrorOnFalse"
+      py_keep_gil: true
+    """)
+    self.assertEqual(code, [
+        'm.def("f", []() {',
+        '  int ret0 = f();',
+        '  PYBIND11_CONSTINIT static '
+        'py::gil_safe_call_once_and_store<py::object> postproc;',
+        '  py::object result = ImportAttrOnce(&postproc, '
+        '"clif.python.postproc", "ValueErrorOnFalse")(ret0);',
+        '  return result;',
+        '}, py::return_value_policy::move);',
+    ])
+    self.assertLen([s for s in code if 'ImportAttrOnce' in s], 1)
+    self.assertNotIn('py::module_::import', '\n'.join(code))
+
+
+if __name__ == '__main__':
+  absltest.main()
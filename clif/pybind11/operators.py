@@ -16,6 +16,7 @@
 from typing import Generator
 
 from clif.protos import ast_pb2
+from clif.pybind11 import function_lib
 from clif.pybind11 import utils
 
 I = utils.I
@@ -111,27 +112,29 @@ def generate_operator(
 
   py_name = func_decl.name.native
   if py_name in UNARY_OPS:
-    yield _generate_unary_operator(module_name, func_decl)
+    operator = _generate_unary_operator(func_decl)
   elif py_name in BINARY_OPS:
-    yield _generate_binary_operator(module_name, func_decl)
+    operator = _generate_binary_operator(func_decl)
   elif py_name in INPLACE_OPS:
-    yield _generate_inplace_operator(module_name, func_decl)
+    operator = _generate_inplace_operator(func_decl)
   elif py_name in REFLECTED_OPS:
-    yield _generate_reflected_operator(module_name, func_decl)
+    operator = _generate_reflected_operator(func_decl)
   else:
     yield ''
+    return
+  if not func_decl.py_keep_gil:
+    operator += f', {function_lib.GIL_RELEASE_CALL_GUARD}'
+  yield f'{module_name}.def({operator});'
 
 
-def _generate_unary_operator(module_name: str,
-                             func_decl: ast_pb2.FuncDecl) -> str:
+def _generate_unary_operator(func_decl: ast_pb2.FuncDecl) -> str:
   py_name = func_decl.name.native
   assert py_name in UNARY_OPS, f'unsupported unary operator: {py_name}'
   operator = UNARY_OPS[func_decl.name.native][1]
-  return f'{module_name}.def({operator}(py::self));'
+  return f'{operator}(py::self)'
 
 
-def _generate_binary_operator(module_name: str,
-                              func_decl: ast_pb2.FuncDecl) -> str:
+def _generate_binary_operator(func_decl: ast_pb2.FuncDecl) -> str:
   """Generates bindings code for binary operators."""
   py_name = func_decl.name.native
   assert py_name in BINARY_OPS, f'unsupported binary operator: {py_name}'
@@ -142,27 +145,25 @@ def _generate_binary_operator(module_name: str,
   else:
     param = func_decl.params[1].cpp_exact_type
   right_operand = _convert_param_to_operand(param)
-  return f'{module_name}.def(py::self {operator} {right_operand});'
+  return f'py::self {operator} {right_operand}'
 
 
-def _generate_inplace_operator(module_name: str,
-                               func_decl: ast_pb2.FuncDecl) -> str:
+def _generate_inplace_operator(func_decl: ast_pb2.FuncDecl) -> str:
   py_name = func_decl.name.native
   assert py_name in INPLACE_OPS, f'unsupported inplace operator: {py_name}'
   assert func_decl.params, f'function {py_name} does not have any parameters'
   operator = INPLACE_OPS[func_decl.name.native][1]
   operand = _convert_param_to_operand(func_decl.params[0].cpp_exact_type)
-  return f'{module_name}.def(py::self {operator} {operand});'
+  return f'py::self {operator} {operand}'
 
 
-def _generate_reflected_operator(module_name: str,
-                                 func_decl: ast_pb2.FuncDecl) -> str:
+def _generate_reflected_operator(func_decl: ast_pb2.FuncDecl) -> str:
   py_name = func_decl.name.native
   assert py_name in REFLECTED_OPS, f'unsupported reflected operator: {py_name}'
   assert func_decl.params, f'function {py_name} does not have any parameters'
   operator = REFLECTED_OPS[func_decl.name.native][1]
   left_operand = _convert_param_to_operand(func_decl.params[0].cpp_exact_type)
-  return f'{module_name}.def({left_operand} {operator} py::self);'
+  return f'{left_operand} {operator} py::self'
 
 
 def _convert_param_to_operand(param: str) -> str:
@@ -17,7 +17,13 @@
 
 #include "Python.h"
 
+#include <memory>
+#include <typeinfo>
+#include <utility>
+
+#include "third_party/pybind11/include/pybind11/gil_safe_call_once.h"
 #include "third_party/pybind11/include/pybind11/pybind11.h"
+#include "clif/python/interop.h"
 
 inline pybind11::object ConvertPyObject(PyObject* ptr) {
   if (PyErr_Occurred() || ptr == nullptr) {
@@ -26,4 +32,43 @@ inline pybind11::object ConvertPyObject(PyObject* ptr) {
   return pybind11::reinterpret_borrow<pybind11::object>(ptr);
 }
 
+// Returns module.name, imported on the first call only. *storage is a
+// PYBIND11_CONSTINIT function-local static of the caller: it has no C++
+// initialization guard, which could deadlock when the import releases the GIL,
+// and it keeps the py::object alive without destroying it at teardown.
+inline pybind11::object ImportAttrOnce(
+    pybind11::gil_safe_call_once_and_store<pybind11::object>* storage,
+    const char* module, const char* name) {
+  return storage
+      ->call_once_and_store_result([module, name] {
+        return pybind11::module_::import(module).attr(name);
+      })
+      .get_stored();
+}
+
+// Shares the C++ objects of a py::classh<T> with Python C API backend
+// wrappers of T generated with --interop (see clif/python/interop.h):
+// defines __clif_shared_ptr__ and accepts those wrappers where T is expected.
+template <typename Class>
+void DefClifInterop(Class& cls) {
+  using T = typename Class::type;
+  cls.def(clif::interop::kSharedPtrMethod, [](std::shared_ptr<T> self) {
+    PyObject* capsule = clif::interop::SharedPtrCapsule(std::move(self));
+    if (capsule == nullptr) throw pybind11::error_already_set();
+    return pybind11::reinterpret_steal<pybind11::object>(capsule);
+  });
+  // Like py::implicitly_convertible, for objects sharing a T only. The new
+  // wrapper shares ownership with the C API wrapper, nothing is copied.
+  pybind11::detail::get_type_info(typeid(T))->implicit_conversions.push_back(
+      [](PyObject* obj, PyTypeObject*) -> PyObject* {
+        std::shared_ptr<T> foreign;
+        if (!clif::interop::GetSharedPtr(obj, &foreign)) {
+          // pybind11 can't propagate errors of implicit conversions.
+          PyErr_Clear();
+          return nullptr;
+        }
+        return pybind11::cast(std::move(foreign)).release().ptr();
+      });
+}
+
 #endif  // THIRD_PARTY_CLIF_PYBIND11_RUNTIME_H_
@@ -24,16 +24,45 @@ Loads CLIF configuration headers with [multiple] -p"types.h" to scan for types.
 
 If invoked with --dump_dir, no output files flags are needed: It
 dumps all output to the given dir.
+
+With --cost_report it also writes a report of the conversions done by every
+wrapped function and property with their estimated copy/allocation cost.
+
+With --c_api the module also exports a versioned table of C++ entry points
+in its _C_API PyCapsule for other native extensions (see clif/python/capi.h).
+With --pxd_out it also writes Cython declarations to get C++ pointers from
+the wrapped objects through that capsule.
+
+With --interop wrapped objects are shared by pointer, without copies, with
+modules generated by the pybind11 backend for the same C++ types (see
+clif/python/interop.h).
+
+With --probes the wrapped functions fire USDT probes for system-level
+profilers when compiled with -DCLIF_USDT_PROBES and are exported under their
+Python qualnames (see clif/python/probes.h).
+
+With --lazy_types class types are built on first use, on module attribute
+access or C++ -> Python conversion, instead of at import.
+
+With --importtime the steps of the module initialization are timed and
+reported like `python -X importtime` does (see ImportTimer in
+clif/python/runtime.h).
+
+With --depfile_out it also writes a Makefile-style depfile listing the .clif
+input, the scanned CLIF headers and every C++ header the matcher read. Its
+target is the -c output unless --depfile_target names it as the build tool
+does.
 """
 
 import argparse
 import os
+import re
 import stat
 import subprocess
 import sys
 
 from clif.protos import ast_pb2
-from clif.python import gen, pyext, pytd2proto  # pylint: disable=g-multiple-import
+from clif.python import cost_report, gen, pyext, pytd2proto  # pylint: disable=g-multiple-import
 import google.protobuf.text_format
 
 FLAGS = None
@@ -67,6 +96,33 @@ def _ParseCommandline(doc, argv):
                       help='output filename for init .cc')
   parser.add_argument('--header_out', '-g', metavar='MODNAME.h',
                       help='output filename for .h')
+  parser.add_argument('--depfile_out', metavar='MODNAME.d',
+                      help='output filename for Makefile-style depfile')
+  parser.add_argument('--depfile_target', metavar='PATH/MODNAME.cc',
+                      help='depfile target if not the -c output filename')
+  parser.add_argument('--cost_report', metavar='MODNAME.cost.txt',
+                      help='output filename for the conversion cost report')
+  parser.add_argument('--c_api', default=False, action='store_true',
+                      help=('Export a C-API capsule with C++ entry points for'
+                            ' other native extensions (see'
+                            ' clif/python/capi.h)'))
+  parser.add_argument('--pxd_out', metavar='MODNAME.pxd',
+                      help=('output filename for Cython declarations to get'
+                            ' C++ pointers from wrapped objects (implies'
+                            ' --c_api)'))
+  parser.add_argument('--interop', default=False, action='store_true',
+                      help=('Share wrapped objects with modules generated by'
+                            ' other CLIF backends (see'
+                            ' clif/python/interop.h)'))
+  parser.add_argument('--probes', default=False, action='store_true',
+                      help=('Fire USDT probes from the wrapped functions and'
+                            ' export them by Python name (see'
+                            ' clif/python/probes.h)'))
+  parser.add_argument('--lazy_types', default=False, action='store_true',
+                      help='Build class types on first use, not at import')
+  parser.add_argument('--importtime', default=False, action='store_true',
+                      help=('Report module initialization steps with'
+                            ' python -X importtime'))
   parser.add_argument('--cc_flags', '-f', default='',
                       help='C++ compiler flags')
   parser.add_argument('--indent', default='  ',
@@ -105,7 +161,12 @@ def GenerateFrom(ast):
       modname,
       ast.typemaps,
       ast.namemaps,
-      indent=FLAGS.indent)
+      indent=FLAGS.indent,
+      c_api=FLAGS.c_api or bool(FLAGS.pxd_out),
+      interop=FLAGS.interop,
+      probes=FLAGS.probes,
+      lazy_types=FLAGS.lazy_types,
+      import_time=FLAGS.importtime)
   inc_headers.append(os.path.basename(FLAGS.header_out))
   # Order of generators is important.
   with open(FLAGS.ccdeps_out, 'w') as cout:
@@ -114,6 +175,21 @@ def GenerateFrom(ast):
     gen.WriteTo(iout, m.GenerateInit(ast.source))
   with open(FLAGS.header_out, 'w') as hout:
     gen.WriteTo(hout, m.GenerateHeader(ast.source, api_header, ast.macros))
+  if FLAGS.pxd_out:
+    with open(FLAGS.pxd_out, 'w') as pout:
+      gen.WriteTo(pout, m.GeneratePxd(ast.source,
+                                      _IncludePath(FLAGS.header_out)))
+
+
+def _IncludePath(filename):
+  """Return the most qualified #include path of filename in include_paths."""
+  path = os.path.abspath(filename)
+  best = os.path.basename(filename)
+  for d in FLAGS.include_paths:
+    rel = os.path.relpath(path, os.path.abspath(d))
+    if not rel.startswith(os.pardir) and len(rel) > len(best):
+      best = rel
+  return best
 
 
 def _GetHeaders(ast):
@@ -146,12 +222,15 @@ def main():
   elif not (FLAGS.ccdeps_out and FLAGS.ccinit_out and FLAGS.header_out):
     raise argparse.ArgumentError(
         '', 'All 3 output files (-c, -i, -h) must be present')
+  if FLAGS.depfile_out and not (FLAGS.depfile_target or FLAGS.ccdeps_out):
+    raise argparse.ArgumentError(
+        '--depfile_out', 'requires -c or --depfile_target')
   if not stat.S_IXUSR & os.stat(FLAGS.matcher_bin).st_mode:
     raise argparse.ArgumentError('--matcher_bin', 'requires an executable')
   try:
     with open(FLAGS.input_filename[0]) as pytd:
       try:
-        bin_pb = _ParseClifSource(pytd, dump_path)
+        bin_pb, deps = _ParseClifSource(pytd, dump_path)
       except Exception as e:  # pylint: disable=broad-except
         print(Err(e))
         return 3
@@ -159,12 +238,23 @@ def main():
     print(Err(e))
     return 2
   # Invoke backend matcher.
-  matcher_cmd = [FLAGS.matcher_bin] + FLAGS.cc_flags.split()
+  matcher_cmd = [FLAGS.matcher_bin]
+  if FLAGS.depfile_out:
+    matcher_depfile = FLAGS.depfile_out + '.matcher'
+    matcher_cmd.append('--dep_file=' + matcher_depfile)
+  matcher_cmd += FLAGS.cc_flags.split()
   try:
     ast = _RunMatcher(matcher_cmd, bin_pb)
+    if FLAGS.depfile_out:
+      deps += _ReadDepFile(matcher_depfile)
+      _WriteDepFile(FLAGS.depfile_out,
+                    FLAGS.depfile_target or FLAGS.ccdeps_out, deps)
   except (OSError, _BackendError) as e:
     print(Err(e))
     return 4
+  finally:
+    if FLAGS.depfile_out and os.path.exists(matcher_depfile):
+      os.remove(matcher_depfile)
   if FLAGS.dump_dir: _DumpProto(dump_path, '.opb', ast)
   # Check matcher output for errors.
   errors = False
@@ -175,6 +265,12 @@ def main():
   if errors:
     print('CLIF backend failed to compile C++ source headers')
     return 5
+  if FLAGS.cost_report:
+    # Report before GenerateFrom as it modifies the AST in place.
+    protos = cost_report.ProtoTypesFromIncludes(ast.usertype_includes,
+                                                FLAGS.include_paths)
+    with open(FLAGS.cost_report, 'w') as f:
+      gen.WriteTo(f, cost_report.GenerateReport(ast, protos))
   try:
     GenerateFrom(ast)
   except Exception as e:  # pylint: disable=broad-except
@@ -213,7 +309,7 @@ def _ParseClifSource(stream, dump_path):
     stream.close()
     raise _ParseError(e)
   if FLAGS.dump_dir: _DumpProto(dump_path, '.ipb', pb)
-  return pb.SerializeToString()
+  return pb.SerializeToString(), [stream.name] + p.dependencies
 
 
 def _RunMatcher(command, data):
@@ -233,6 +329,34 @@ def _RunMatcher(command, data):
   return ast
 
 
+def _ReadDepFile(filename):
+  """Return the prerequisites listed in a single-rule Makefile depfile."""
+  with open(filename) as f:
+    rule = f.read().replace('\\\n', ' ')
+  _, _, prerequisites = rule.partition(': ')
+  return [_UnescapeDep(d) for d in re.split(r'(?<!\\)\s+', prerequisites) if d]
+
+
+def _UnescapeDep(name):
+  return name.replace('\\ ', ' ').replace('\\#', '#').replace('$$', '$')
+
+
+def _EscapeDep(name):
+  return name.replace('$', '$$').replace('#', '\\#').replace(' ', '\\ ')
+
+
+def _WriteDepFile(filename, target, deps):
+  """Write a Makefile-style depfile with unique deps in first-seen order."""
+  seen = set()
+  with open(filename, 'w') as f:
+    f.write(_EscapeDep(target) + ':')
+    for d in deps:
+      if d not in seen:
+        seen.add(d)
+        f.write(' \\\n  ' + _EscapeDep(d))
+    f.write('\n')
+
+
 def _DumpProto(dump_path, ext, pb):
   if FLAGS.binary_dump:
     with open(dump_path+ext, 'wb') as f:
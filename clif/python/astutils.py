@@ -23,6 +23,12 @@ def HaveEnum(decls):
               if d.decltype == d.CLASS))
 
 
+def AnyClass(decls, predicate):
+  """Whether predicate(ClassDecl) is true for a [nested] class in decls."""
+  return any(predicate(d.class_) or AnyClass(d.class_.members, predicate)
+             for d in decls if d.decltype == d.CLASS)
+
+
 def Type(p):
   return p.type.cpp_type
 
@@ -59,11 +65,16 @@ def FuncParamStr(fdecl, arg_name=None, true_cpp_type=False):
     return TupleStr(itertools.chain((Type(a) for a in fdecl.params),
                                     FuncReturns(fdecl)))
   assert true_cpp_type, 'arg_name make sense only for true_cpp_type'
+  return TupleStr('%s %s%d' % (a, arg_name, i)
+                  for i, a in enumerate(FuncExactParamTypes(fdecl)))
+
+
+def FuncExactParamTypes(fdecl):
+  """List C++ parameter types of the func including output parameters."""
   # Skip returns[0] if not void.
   returns = fdecl.returns if fdecl.cpp_void_return else fdecl.returns[1:]
-  args = ([ExactTypeOrType(a) for a in fdecl.params] +
+  return ([ExactTypeOrType(a) for a in fdecl.params] +
           [ExactTypeOrType(a, '*') for a in returns])
-  return TupleStr('%s %s%d' % (a, arg_name, i) for i, a in enumerate(args))
 
 
 def Docstring(method):
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Python.h>
+
+#include "clif/python/buffer.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace clif {
+namespace buffer {
+namespace {
+
+// Owned by Py_buffer.internal, the view's format, shape and strides point
+// into |layout|.
+struct Exported {
+  std::shared_ptr<void> owner;
+  Layout layout;
+};
+
+// Whether the strides of |l| are contiguous in C (last index varies fastest)
+// or Fortran order.
+bool IsContiguous(const Layout& l, bool c_order) {
+  Py_ssize_t expected = l.itemsize;
+  const std::size_t ndim = l.shape.size();
+  for (std::size_t i = 0; i < ndim; ++i) {
+    const std::size_t d = c_order ? ndim - 1 - i : i;
+    if (l.shape[d] == 0) return true;
+    if (l.shape[d] != 1 && l.strides[d] != expected) return false;
+    expected *= l.shape[d];
+  }
+  return true;
+}
+
+int Error(PyObject* self, const char* what) {
+  PyErr_Format(PyExc_BufferError, "%s buffer %s", Py_TYPE(self)->tp_name,
+               what);
+  return -1;
+}
+
+}  // namespace
+
+int FillView(PyObject* self, Py_buffer* view, int flags,
+             std::shared_ptr<void> owner, Layout layout) {
+  view->obj = nullptr;
+  if (layout.readonly && (flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+    return Error(self, "is read-only");
+  }
+  const std::size_t ndim = layout.shape.size();
+  if (!layout.strides.empty() && layout.strides.size() != ndim) {
+    return Error(self, "strides and shape have different dimensions");
+  }
+  Py_ssize_t len = layout.itemsize;
+  for (Py_ssize_t n : layout.shape) {
+    if (n < 0) return Error(self, "shape is negative");
+    len *= n;
+  }
+  if (layout.strides.empty()) {
+    layout.strides.resize(ndim);
+    Py_ssize_t stride = layout.itemsize;
+    for (std::size_t d = ndim; d-- > 0;) {
+      layout.strides[d] = stride;
+      stride *= layout.shape[d];
+    }
+  }
+  const bool c_contiguous = IsContiguous(layout, true);
+  const bool f_contiguous = IsContiguous(layout, false);
+  if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && !c_contiguous) {
+    return Error(self, "is not C-contiguous, strides are required");
+  }
+  if ((flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS && !c_contiguous) {
+    return Error(self, "is not C-contiguous");
+  }
+  if ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS && !f_contiguous) {
+    return Error(self, "is not Fortran-contiguous");
+  }
+  if ((flags & PyBUF_ANY_CONTIGUOUS) == PyBUF_ANY_CONTIGUOUS &&
+      !c_contiguous && !f_contiguous) {
+    return Error(self, "is not contiguous");
+  }
+  auto* exported = new Exported{std::move(owner), std::move(layout)};
+  const Layout& l = exported->layout;
+  view->buf = l.data;
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = len;
+  view->readonly = l.readonly;
+  view->itemsize = l.itemsize;
+  view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT
+                     ? const_cast<char*>(l.format.c_str())
+                     : nullptr;
+  if ((flags & PyBUF_ND) == PyBUF_ND) {
+    view->ndim = static_cast<int>(ndim);
+    view->shape = const_cast<Py_ssize_t*>(l.shape.data());
+  } else {
+    // A flat array of bytes.
+    view->ndim = 1;
+    view->shape = nullptr;
+  }
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES
+                      ? const_cast<Py_ssize_t*>(l.strides.data())
+                      : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = exported;
+  return 0;
+}
+
+void Release(PyObject*, Py_buffer* view) {
+  delete static_cast<Exported*>(view->internal);
+  view->internal = nullptr;
+}
+
+}  // namespace buffer
+}  // namespace clif
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_BUFFER_H_
+#define CLIF_PYTHON_BUFFER_H_
+
+/*
+Buffer protocol of a class with a .clif buffer statement, exporting its
+contiguous (or strided) C++ storage without copies:
+
+  class Tile:
+    buffer(data=`data`, shape=`dims`, strides=`byte_strides`)
+
+The generated bf_getbuffer calls the declared accessors and passes the results
+to Export:
+
+  data     T*, or const T* for a read-only buffer
+  shape    an integer (a 1-D buffer) or a range of integers, size() by default
+  strides  a range of integers in bytes, C-contiguous by default
+  format   a struct module format string, by default derived from T
+
+The view holds a reference to the wrapper and shares the ownership of its C++
+instance, so the storage outlives the view and the instance can't be
+transferred to C++ (as std::unique_ptr) while it is exported.
+*/
+
+#include <Python.h>
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace clif {
+namespace buffer {
+
+// Placeholders for the strides and format accessors when not declared.
+struct CContiguous {};
+struct ElementFormat {};
+
+// The exported storage, see Export.
+struct Layout {
+  void* data = nullptr;
+  bool readonly = false;
+  Py_ssize_t itemsize = 0;
+  std::string format;
+  std::vector<Py_ssize_t> shape;
+  std::vector<Py_ssize_t> strides;  // Empty for C-contiguous.
+};
+
+// Fills |view| as requested by |flags| (see PyObject_GetBuffer) to export
+// |layout| of |self|, which is kept alive with |owner| until Release.
+// Returns 0, or -1 with a Python exception set.
+int FillView(PyObject* self, Py_buffer* view, int flags,
+             std::shared_ptr<void> owner, Layout layout);
+
+// bf_releasebuffer of the views filled by FillView.
+void Release(PyObject* self, Py_buffer* view);
+
+namespace internal {
+
+// struct module format of T, or nullptr.
+template <typename T>
+constexpr const char* FormatOf() {
+  using U = std::remove_cv_t<T>;
+  if constexpr (std::is_same_v<U, bool>) {
+    return "?";
+  } else if constexpr (std::is_same_v<U, char>) {
+    return "c";
+  } else if constexpr (std::is_integral_v<U>) {
+    // By size, eg. int64_t is "q" whether it is a long or a long long.
+    constexpr bool is_signed = std::is_signed_v<U>;
+    switch (sizeof(U)) {
+      case 1: return is_signed ? "b" : "B";
+      case 2: return is_signed ? "h" : "H";
+      case 4: return is_signed ? "i" : "I";
+      case 8: return is_signed ? "q" : "Q";
+      default: return nullptr;
+    }
+  } else if constexpr (std::is_same_v<U, float>) {
+    return "f";
+  } else if constexpr (std::is_same_v<U, double>) {
+    return "d";
+  } else if constexpr (std::is_same_v<U, std::complex<float>>) {
+    return "Zf";
+  } else if constexpr (std::is_same_v<U, std::complex<double>>) {
+    return "Zd";
+  } else {
+    return nullptr;
+  }
+}
+
+}  // namespace internal
+
+// bf_getbuffer body: exports |data| of |self| (owned by |owner|) as described
+// by the shape, strides and format accessor results.
+template <typename T, typename Shape, typename Strides, typename Format>
+int Export(PyObject* self, Py_buffer* view, int flags,
+           std::shared_ptr<void> owner, T* data, const Shape& shape,
+           const Strides& strides, const Format& format) {
+  static_assert(!std::is_void_v<T>,
+                "buffer data accessor must return a typed pointer");
+  Layout layout;
+  layout.data = const_cast<void*>(static_cast<const void*>(data));
+  layout.readonly = std::is_const_v<T>;
+  layout.itemsize = sizeof(T);
+  if constexpr (std::is_same_v<Format, ElementFormat>) {
+    static_assert(internal::FormatOf<T>() != nullptr,
+                  "declare a buffer format accessor for this element type");
+    layout.format = internal::FormatOf<T>();
+  } else {
+    layout.format = std::string(format);
+  }
+  if constexpr (std::is_integral_v<Shape>) {
+    layout.shape.push_back(static_cast<Py_ssize_t>(shape));
+  } else {
+    for (const auto& n : shape) {
+      layout.shape.push_back(static_cast<Py_ssize_t>(n));
+    }
+  }
+  if constexpr (!std::is_same_v<Strides, CContiguous>) {
+    for (const auto& s : strides) {
+      layout.strides.push_back(static_cast<Py_ssize_t>(s));
+    }
+  }
+  return FillView(self, view, flags, std::move(owner), std::move(layout));
+}
+
+}  // namespace buffer
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_BUFFER_H_
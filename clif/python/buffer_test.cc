@@ -0,0 +1,150 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "clif/python/buffer.h"
+
+#include <Python.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace clif {
+namespace buffer {
+namespace {
+
+class BufferTest : public ::testing::Test {
+ protected:
+  BufferTest() { Py_Initialize(); }
+
+  // Any object stands in for the wrapper, it is only referenced by the view.
+  void SetUp() override { self_ = PyList_New(0); }
+  void TearDown() override { Py_DECREF(self_); }
+
+  // What PyBuffer_Release would do with a wrapper type.
+  void ReleaseView(Py_buffer* view) {
+    Release(view->obj, view);
+    Py_CLEAR(view->obj);
+  }
+
+  PyObject* self_ = nullptr;
+};
+
+TEST_F(BufferTest, OneDimensional) {
+  auto v = std::make_shared<std::vector<double>>(3, 0.5);
+  Py_buffer view;
+  ASSERT_EQ(Export(self_, &view, PyBUF_FULL, v, v->data(), v->size(),
+                   CContiguous(), ElementFormat()),
+            0);
+  EXPECT_EQ(view.obj, self_);
+  EXPECT_EQ(view.buf, v->data());
+  EXPECT_EQ(view.len, 24);
+  EXPECT_EQ(view.itemsize, 8);
+  EXPECT_FALSE(view.readonly);
+  EXPECT_STREQ(view.format, "d");
+  ASSERT_EQ(view.ndim, 1);
+  EXPECT_EQ(view.shape[0], 3);
+  EXPECT_EQ(view.strides[0], 8);
+  // The view shares the ownership of the C++ object.
+  EXPECT_EQ(v.use_count(), 2);
+  ReleaseView(&view);
+  EXPECT_EQ(v.use_count(), 1);
+}
+
+TEST_F(BufferTest, ReadOnly) {
+  auto v = std::make_shared<std::vector<std::uint8_t>>(4);
+  const std::uint8_t* data = v->data();
+  Py_buffer view;
+  EXPECT_EQ(Export(self_, &view, PyBUF_WRITABLE, v, data, v->size(),
+                   CContiguous(), ElementFormat()),
+            -1);
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_BufferError));
+  PyErr_Clear();
+  EXPECT_EQ(view.obj, nullptr);
+  EXPECT_EQ(v.use_count(), 1);
+  ASSERT_EQ(Export(self_, &view, PyBUF_SIMPLE, v, data, v->size(),
+                   CContiguous(), ElementFormat()),
+            0);
+  EXPECT_TRUE(view.readonly);
+  EXPECT_EQ(view.format, nullptr);  // Unsigned bytes.
+  EXPECT_EQ(view.shape, nullptr);
+  EXPECT_EQ(view.len, 4);
+  ReleaseView(&view);
+}
+
+TEST_F(BufferTest, Strided) {
+  // A 2x3 matrix of int64 in Fortran order.
+  auto m = std::make_shared<std::array<std::int64_t, 6>>();
+  const std::vector<int> shape = {2, 3};
+  const std::vector<int> strides = {8, 16};
+  Py_buffer view;
+  EXPECT_EQ(Export(self_, &view, PyBUF_C_CONTIGUOUS, m, m->data(), shape,
+                   strides, ElementFormat()),
+            -1);
+  PyErr_Clear();
+  EXPECT_EQ(Export(self_, &view, PyBUF_SIMPLE, m, m->data(), shape, strides,
+                   ElementFormat()),
+            -1);
+  PyErr_Clear();
+  ASSERT_EQ(Export(self_, &view, PyBUF_F_CONTIGUOUS | PyBUF_FORMAT, m,
+                   m->data(), shape, strides, ElementFormat()),
+            0);
+  EXPECT_STREQ(view.format, "q");
+  ASSERT_EQ(view.ndim, 2);
+  EXPECT_EQ(view.shape[1], 3);
+  EXPECT_EQ(view.strides[1], 16);
+  EXPECT_EQ(view.len, 6 * 8);
+  ReleaseView(&view);
+}
+
+TEST_F(BufferTest, DeclaredFormat) {
+  struct Pixel {
+    std::uint8_t r, g, b;
+  };
+  auto p = std::make_shared<std::vector<Pixel>>(2);
+  Py_buffer view;
+  ASSERT_EQ(Export(self_, &view, PyBUF_RECORDS, p, p->data(), p->size(),
+                   CContiguous(), "BBB"),
+            0);
+  EXPECT_STREQ(view.format, "BBB");
+  EXPECT_EQ(view.itemsize, 3);
+  ReleaseView(&view);
+}
+
+TEST_F(BufferTest, InconsistentStrides) {
+  auto v = std::make_shared<std::vector<float>>(4);
+  Py_buffer view;
+  EXPECT_EQ(Export(self_, &view, PyBUF_FULL, v, v->data(), v->size(),
+                   std::vector<int>{4, 4}, ElementFormat()),
+            -1);
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_BufferError));
+  PyErr_Clear();
+}
+
+TEST(FormatOfTest, Types) {
+  EXPECT_STREQ(internal::FormatOf<bool>(), "?");
+  EXPECT_STREQ(internal::FormatOf<const std::int16_t>(), "h");
+  EXPECT_STREQ(internal::FormatOf<std::uint32_t>(), "I");
+  EXPECT_STREQ(internal::FormatOf<long long>(), "q");  // NOLINT: runtime/int
+  EXPECT_STREQ(internal::FormatOf<std::complex<double>>(), "Zd");
+  EXPECT_EQ(internal::FormatOf<std::vector<int>>(), nullptr);
+}
+
+}  // namespace
+}  // namespace buffer
+}  // namespace clif
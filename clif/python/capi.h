@@ -0,0 +1,95 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_CAPI_H_
+#define CLIF_PYTHON_CAPI_H_
+
+/*
+A CLIF module generated with pyclif --c_api exports a table of C++ function
+pointers in its "_C_API" attribute (a PyCapsule), like numpy's C-API capsule.
+Other native extensions (CLIF modules, Cython or hand-written C++ modules)
+include the CLIF-generated module header and call
+
+  const module_clifwrap::CApi* api = module_clifwrap::CApi::Import();
+  if (api == nullptr) return nullptr;  // ImportError is set.
+  Foo* foo = api->Foo_ThisPtr(pyobj);
+
+to get C++ pointers from and create instances of the wrapped classes and
+to call the wrapped functions directly, without Python call overhead.
+For each class the header also has capi::Foo_ThisPtr(pyobj), which Cython
+code cimports from the .pxd written by pyclif --pxd_out.
+The table is valid for the life of the process; as for any Python C API,
+Import() and the ThisPtr/From entries must be called with the GIL held.
+*/
+
+#include "Python.h"
+#include <cstdint>
+#include <cstring>
+
+namespace clif {
+namespace capi {
+
+// Bumped on incompatible changes of the table layout rules.
+constexpr uint32_t kVersion = 1;
+
+// The first member of every generated CApi table.
+struct TableHeader {
+  uint32_t version;
+  // Comma-separated names of the table entries, checked on import to detect
+  // a header that does not match the loaded module.
+  const char* layout;
+};
+
+// Returns false and sets ImportError if the header does not match.
+inline bool CheckTable(const TableHeader& header, const char* capsule_name,
+                       const char* layout) {
+  if (header.version != kVersion) {
+    PyErr_Format(PyExc_ImportError, "%s version %u, expected %u",
+                 capsule_name, header.version, kVersion);
+    return false;
+  }
+  if (std::strcmp(header.layout, layout) != 0) {
+    PyErr_Format(PyExc_ImportError,
+                 "%s does not match the header it was compiled with, rebuild"
+                 " the importing extension", capsule_name);
+    return false;
+  }
+  return true;
+}
+
+// Imports the table from the module; returns nullptr with ImportError set.
+template <typename Table>
+const Table* Import() {
+  auto* table = static_cast<const Table*>(
+      PyCapsule_Import(Table::kCapsuleName, 0));
+  if (table == nullptr ||
+      !CheckTable(table->header, Table::kCapsuleName, Table::kLayout)) {
+    return nullptr;
+  }
+  return table;
+}
+
+// Import() once per extension; retried on the next call after a failure.
+template <typename Table>
+const Table* Get() {
+  static const Table* table = nullptr;
+  if (table == nullptr) table = Import<Table>();
+  return table;
+}
+
+}  // namespace capi
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_CAPI_H_
@@ -134,8 +134,13 @@ class ClassTest(unittest.TestCase):
         {}
       };
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -144,9 +149,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructTy", sizeof(StructTy)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -185,9 +194,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_getset = Properties;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -204,9 +214,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructTy* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -335,9 +352,14 @@ class ClassTest(unittest.TestCase):
         return PyCapsule_New(p, "::Base<Foo*, const Bar&>", nullptr);
       }
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"as_Base_Foo_ptr_constBar_ref", (PyCFunction)as_Base_Foo_ptr_constBar_ref, METH_NOARGS, "Upcast to ::Base<Foo*, const Bar&>*"},
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -346,9 +368,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructTy", sizeof(StructTy)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -389,9 +415,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_getset = Properties;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -408,9 +435,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructTy* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -531,8 +565,13 @@ class ClassTest(unittest.TestCase):
         {}
       };
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -541,9 +580,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructTy", sizeof(StructTy)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -584,9 +627,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_getset = Properties;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -603,9 +647,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructTy* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -803,8 +854,13 @@ class ClassTest(unittest.TestCase):
         {}
       };
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -813,9 +869,13 @@ class ClassTest(unittest.TestCase):
 
       // Inner __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"OutKlass::InnKlass", sizeof(OutKlass::InnKlass)};
 
       // Inner __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -854,9 +914,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_getset = Properties;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -873,9 +934,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static OutKlass::InnKlass* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -907,8 +975,13 @@ class ClassTest(unittest.TestCase):
 
       }  // namespace pyInner
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -917,9 +990,13 @@ class ClassTest(unittest.TestCase):
 
       // Outer __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"OutKlass", sizeof(OutKlass)};
 
       // Outer __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -957,9 +1034,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_methods = MethodsStaticAlloc;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -976,9 +1054,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static OutKlass* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -1137,8 +1222,13 @@ class ClassTest(unittest.TestCase):
         {}
       };
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -1147,9 +1237,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructTy", sizeof(StructTy)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -1188,9 +1282,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_getset = Properties;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -1207,9 +1302,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructTy* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -1329,10 +1431,15 @@ class ClassTest(unittest.TestCase):
         return nullptr;
       }
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"get_a", (PyCFunction)get_a, METH_NOARGS, "get_a()->int  C++ StructTy.a getter"},
         {"set_a", set_a, METH_O, "set_a(int)  C++ StructTy.a setter"},
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -1341,9 +1448,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructTy", sizeof(StructTy)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -1381,9 +1492,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_methods = MethodsStaticAlloc;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -1400,9 +1512,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructTy* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -1565,8 +1684,13 @@ class ClassTest(unittest.TestCase):
         {}
       };
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -1575,9 +1699,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructTy", sizeof(StructTy)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -1616,9 +1744,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_getset = Properties;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -1635,9 +1764,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructTy* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -1715,9 +1851,14 @@ class ClassTest(unittest.TestCase):
         Py_RETURN_NONE;
       }
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"f", (PyCFunction)wrapf, METH_NOARGS, "f()\n  Calls C++ function\n  void f()"},
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -1726,9 +1867,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructCpp", sizeof(StructCpp)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -1766,9 +1911,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_methods = MethodsStaticAlloc;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -1785,9 +1931,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructCpp* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -1831,6 +1984,464 @@ class ClassTest(unittest.TestCase):
       }
     """))
 
+  def testLazyFinalStruct(self):
+    self.m.lazy_types = True
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Struct"
+        cpp_name: "StructCpp"
+      }
+      final: true
+      cpp_has_trivial_dtor: true
+    """, ast)
+    out = '\n'.join(self.m.WrapClass(ast, -1, ''))
+    self.assertIn('static bool ReadyType();', out)
+    self.assertIn('  if (!ReadyType()) return nullptr;\n', out)
+    out = '\n'.join(itertools.chain(
+        self.m.GenLazyTypes(),
+        self.m.GenTypesReady(),
+        self.m.GenInitFunction('test.h'),
+        ))+'\n'
+    self.assertMultiLineEqual(out, textwrap.dedent(r"""
+      namespace pyStruct {
+
+      static bool BuildTypes() {
+        PyTypeObject* type0 =
+        pyStruct::_build_heap_type();
+        if (PyType_Ready(type0) < 0) return false;
+        PyObject *modname = PyUnicode_FromString(ThisModuleName);
+        if (modname == nullptr) return false;
+        PyObject_SetAttrString((PyObject *) type0, "__module__", modname);
+        Py_INCREF(type0);  // For PyModule_AddObject to steal.
+        pyStruct::wrapper_Type = type0;
+        return true;
+      }
+
+      static bool ReadyType() {
+        static bool ready = false;
+        static unsigned long builder = 0;  // Thread ident, 0 if none.
+        static PyThread_type_lock building = PyThread_allocate_lock();
+        // Building runs Python code (imports of bases), which may use it
+        // in this thread or release the GIL to other threads.
+        while (!ready && builder != 0) {
+          if (builder == PyThread_get_thread_ident()) {
+            PyErr_SetString(PyExc_ImportError, "class Struct is used while it is being built");
+            return false;
+          }
+          // Wait for the other thread to finish, without the GIL.
+          Py_BEGIN_ALLOW_THREADS
+          PyThread_acquire_lock(building, WAIT_LOCK);
+          PyThread_release_lock(building);
+          Py_END_ALLOW_THREADS
+        }
+        if (ready) return true;
+        if (building == nullptr) {
+          PyErr_NoMemory();
+          return false;
+        }
+        builder = PyThread_get_thread_ident();
+        PyThread_acquire_lock(building, WAIT_LOCK);
+        bool ok = BuildTypes();
+        PyThread_release_lock(building);
+        builder = 0;
+        if (!ok) {
+          pyStruct::wrapper_Type = nullptr;
+          return false;
+        }
+        ready = true;
+        return true;
+      }
+
+      static PyObject* GetType() {
+        if (!ReadyType()) return nullptr;
+        return reinterpret_cast<PyObject*>(wrapper_Type);
+      }
+
+      }  // namespace pyStruct
+
+      static const struct {
+        const char* name;
+        PyObject* (*get)();  // Borrowed reference.
+      } kLazyTypes[] = {
+        {"Struct", pyStruct::GetType},
+      };
+
+      static PyObject* LazyGetAttr(PyObject* module, PyObject* name) {
+        const char* n = PyUnicode_AsUTF8(name);
+        if (n == nullptr) return nullptr;
+        for (const auto& t : kLazyTypes) {
+          if (strcmp(n, t.name) != 0) continue;
+          PyObject* obj = t.get();
+          if (obj == nullptr) return nullptr;
+          // Next lookups find it in the module dict.
+          if (PyObject_SetAttr(module, name, obj) < 0) return nullptr;
+          Py_INCREF(obj);
+          return obj;
+        }
+        PyErr_Format(PyExc_AttributeError, "module '%s' has no attribute '%s'", ThisModuleName, n);
+        return nullptr;
+      }
+
+      static PyObject* LazyDir(PyObject* module, PyObject*) {
+        PyObject* dict = PyModule_GetDict(module);
+        PyObject* names = PyDict_Keys(dict);
+        if (names == nullptr) return nullptr;
+        for (const auto& t : kLazyTypes) {
+          if (PyDict_GetItemString(dict, t.name) != nullptr) continue;
+          PyObject* name = PyUnicode_FromString(t.name);
+          if (name == nullptr || PyList_Append(names, name) < 0) {
+            Py_XDECREF(name);
+            Py_DECREF(names);
+            return nullptr;
+          }
+          Py_DECREF(name);
+        }
+        return names;
+      }
+
+      bool Ready() {
+        return true;
+      }
+
+      static struct PyModuleDef Module = {
+        PyModuleDef_HEAD_INIT,
+        ThisModuleName,
+        "CLIF-generated module for test.h", // module doc
+        -1,  // module keeps state in global variables
+        MethodsStaticAlloc,
+        nullptr,  // m_slots a.k.a. m_reload
+        nullptr,  // m_traverse
+        ClearImportCache  // m_clear
+      };
+
+      PyObject* Init() {
+        PyObject* module = PyModule_Create(&Module);
+        if (!module) return nullptr;
+        return module;
+      }
+    """))
+
+  def testImportTimeStruct(self):
+    self.m.import_time = True
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Struct"
+        cpp_name: "StructCpp"
+      }
+      bases {
+        native: "ImportedBase"
+      }
+      final: true
+      cpp_has_trivial_dtor: true
+      members {
+        decltype: CONST
+        const {
+          name {
+            native: "Const"
+            cpp_name: "kConst"
+          }
+          type {
+            lang_type: "int"
+            cpp_type: "int"
+          }
+        }
+      }
+    """, ast)
+    list(self.m.WrapClass(ast, -1, ''))
+    out = '\n'.join(itertools.chain(
+        self.m.GenTypesReady(),
+        self.m.GenInitFunction('test.h'),
+        ))+'\n'
+    self.assertMultiLineEqual(out, textwrap.dedent("""
+      bool Ready() {
+        ::clif::ImportTimer import_time(ThisModuleName, "Ready()");
+        import_time.Step("class Struct");
+        pyStruct::wrapper_Type =
+        pyStruct::_build_heap_type();
+        import_time.Step("import base path.python.Base");
+        PyObject* base_cls = ImportFQName("path.python.Base");
+        if (base_cls == nullptr) return false;
+        if (!PyObject_TypeCheck(base_cls, &PyType_Type)) {
+          Py_DECREF(base_cls);
+          PyErr_SetString(PyExc_TypeError, "Base class path.python.Base is not a new style class inheriting from object.");
+          return false;
+        }
+        pyStruct::wrapper_Type->tp_base = reinterpret_cast<PyTypeObject*>(base_cls);
+        // Check that base_cls is a *statically* allocated PyType.
+        if (pyStruct::wrapper_Type->tp_base->tp_alloc == PyType_GenericAlloc) {
+          Py_DECREF(base_cls);
+          PyErr_SetString(PyExc_TypeError, "Base class path.python.Base is a dynamic (Python defined) class.");
+          return false;
+        }
+        if (PyType_Ready(pyStruct::wrapper_Type) < 0) return false;
+        PyObject *modname = PyUnicode_FromString(ThisModuleName);
+        if (modname == nullptr) return false;
+        PyObject_SetAttrString((PyObject *) pyStruct::wrapper_Type, "__module__", modname);
+        Py_INCREF(pyStruct::wrapper_Type);  // For PyModule_AddObject to steal.
+        return true;
+      }
+
+      static struct PyModuleDef Module = {
+        PyModuleDef_HEAD_INIT,
+        ThisModuleName,
+        "CLIF-generated module for test.h", // module doc
+        -1,  // module keeps state in global variables
+        nullptr,
+        nullptr,  // m_slots a.k.a. m_reload
+        nullptr,  // m_traverse
+        ClearImportCache  // m_clear
+      };
+
+      PyObject* Init() {
+        ::clif::ImportTimer import_time(ThisModuleName, "Init()");
+        import_time.Step("PyModule_Create");
+        PyObject* module = PyModule_Create(&Module);
+        if (!module) return nullptr;
+        import_time.Step("Struct.Const");
+        if (PyDict_SetItemString(pyStruct::wrapper_Type->tp_dict, "Const", Clif_PyObjFrom(static_cast<int>(kConst), {})) < 0) goto err;
+        import_time.Step("Struct");
+        if (PyModule_AddObject(module, "Struct", reinterpret_cast<PyObject*>(pyStruct::wrapper_Type)) < 0) goto err;
+        return module;
+      err:
+        Py_DECREF(module);
+        return nullptr;
+      }
+    """))
+
+  def testValueStruct(self):
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Key"
+        cpp_name: "KeyCpp"
+      }
+      final: true
+      cpp_has_trivial_dtor: true
+      cpp_has_eq: true
+      cpp_has_lt: true
+      cpp_hasher: "::std::hash"
+    """, ast)
+    out = '\n'.join(self.m.WrapClass(ast, -1, ''))
+    self.assertIn(textwrap.dedent("""
+      static KeyCpp* ThisPtr(PyObject*);
+
+      static Py_hash_t cpp_hash(PyObject* self) {
+        KeyCpp* c = ThisPtr(self);
+        if (c == nullptr) return -1;
+        return ::clif::slot::hash_value(::std::hash<KeyCpp>()(*c));
+      }
+
+      extern PyTypeObject* wrapper_Type;
+      static PyObject* cpp_richcmp(PyObject* self, PyObject* other, int op) {
+        if (!PyObject_TypeCheck(other, wrapper_Type)) Py_RETURN_NOTIMPLEMENTED;
+        KeyCpp* a = ThisPtr(self);
+        if (a == nullptr) return nullptr;
+        KeyCpp* b = ThisPtr(other);
+        if (b == nullptr) return nullptr;
+        bool r;
+        switch (op) {
+          case Py_EQ: r = *a == *b; break;
+          case Py_NE: r = !(*a == *b); break;
+          case Py_LT: r = *a < *b; break;
+          case Py_GT: r = *b < *a; break;
+          case Py_LE: r = !(*b < *a); break;
+          case Py_GE: r = !(*a < *b); break;
+          default: Py_RETURN_NOTIMPLEMENTED;
+        }
+        return PyBool_FromLong(r);
+      }
+    """), out)
+    self.assertIn('  ty->tp_hash = cpp_hash;\n', out)
+    self.assertIn('  ty->tp_richcompare = cpp_richcmp;\n', out)
+
+  def testValueStructClifHash(self):
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Key"
+        cpp_name: "KeyCpp"
+      }
+      cpp_has_eq: true
+      cpp_hasher: "::absl::Hash"
+      members {
+        decltype: FUNC
+        func {
+          name {
+            native: "__hash__"
+            cpp_name: "Hash"
+          }
+          returns {
+            type {
+              lang_type: "int"
+              cpp_type: "int"
+            }
+          }
+        }
+      }
+    """, ast)
+    out = '\n'.join(self.m.WrapClass(ast, -1, ''))
+    self.assertNotIn('cpp_hash', out)
+    self.assertNotIn('cpp_richcmp', out)
+    self.assertIn('  ty->tp_hash = slot::adapter<', out)
+
+  def testContainerProtocolStruct(self):
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Names"
+        cpp_name: "NamesCpp"
+      }
+      final: true
+      container_protocol: true
+      members {
+        decltype: FUNC
+        func {
+          name {
+            native: "__len__"
+            cpp_name: "Len"
+          }
+          returns {
+            type {
+              lang_type: "int"
+              cpp_type: "int"
+            }
+          }
+        }
+      }
+    """, ast)
+    out = '\n'.join(self.m.WrapClass(ast, -1, ''))
+    self.assertIn('\nstatic NamesCpp* ThisPtr(PyObject*);\n', out)
+    # __len__ declared in .clif wins over C++ size().
+    self.assertIn(
+        '  ty->tp_as_sequence->sq_length = slot::adapter<Py_ssize_t,'
+        ' slot::as_size, wrapLen_as___len__>;\n'
+        '  ty->tp_as_sequence->sq_item ='
+        ' ::clif::container::SqItem<NamesCpp, ThisPtr>();\n'
+        '  ty->tp_as_sequence->sq_contains ='
+        ' ::clif::container::SqContains<NamesCpp, ThisPtr>();\n'
+        '  ty->tp_as_mapping->mp_length = slot::adapter<Py_ssize_t,'
+        ' slot::as_size, wrapLen_as___len__>;\n'
+        '  ty->tp_as_mapping->mp_subscript ='
+        ' ::clif::container::MpSubscript<NamesCpp, ThisPtr>();\n', out)
+
+  def testFinalStructFields(self):
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Point"
+        cpp_name: "PointCpp"
+      }
+      final: true
+      members {
+        decltype: VAR
+        var {
+          name {
+            native: "x"
+            cpp_name: "x"
+          }
+          type {
+            lang_type: "float"
+            cpp_type: "double"
+          }
+        }
+      }
+      members {
+        decltype: VAR
+        var {
+          name {
+            native: "label"
+            cpp_name: "label"
+          }
+          type {
+            lang_type: "bytes"
+            cpp_type: "::std::string"
+          }
+        }
+      }
+    """, ast)
+    out = '\n'.join(self.m.WrapClass(ast, -1, ''))
+    self.assertIn(
+        'static PyObject* get_x(PyObject* self, void* xdata) {\n'
+        '  auto* c = ::clif::python::Get('
+        'reinterpret_cast<wrapper*>(self)->cpp);\n'
+        '  if (c == nullptr) return nullptr;\n'
+        '  return ::clif::field::ToPy(c->x);\n'
+        '}\n', out)
+    self.assertIn(
+        '  auto* c = ::clif::python::Get('
+        'reinterpret_cast<wrapper*>(self)->cpp);\n'
+        '  if (c == nullptr) return -1;\n'
+        '  if (::clif::field::FromPy(value, &c->x)) return 0;\n', out)
+    # Other types keep the generic conversions.
+    self.assertIn(
+        'return Clif_PyObjFrom(reinterpret_cast<wrapper*>(self)->cpp->label,',
+        out)
+    self.assertIn('{"x", get_x, set_x, "C++ double PointCpp.x"},', out)
+
+  def testViewVar(self):
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Holder"
+        cpp_name: "HolderCpp"
+      }
+      members {
+        decltype: VAR
+        var {
+          name {
+            native: "values"
+            cpp_name: "values"
+          }
+          type {
+            lang_type: "list<int>"
+            cpp_type: "::std::vector<int>"
+          }
+          view: true
+        }
+      }
+    """, ast)
+    out = '\n'.join(self.m.WrapClass(ast, -1, ''))
+    self.assertIn(
+        '  auto cpp = ThisPtr(self); if (!cpp) return nullptr;\n'
+        '  return Clif_PyObjFrom(::clif::view::Of(::clif::MakeStdShared('
+        'reinterpret_cast<wrapper*>(self)->cpp, &cpp->values)), {});\n', out)
+    self.assertIn(
+        '  auto cpp = ThisPtr(self); if (!cpp) return -1;\n'
+        '  if (::clif::view::Assign(value, &cpp->values)) return 0;\n'
+        '  if (Clif_PyObjAs(value, &cpp->values)) return 0;\n', out)
+
+  def testBufferStruct(self):
+    ast = ast_pb2.ClassDecl()
+    text_format.Parse("""
+      name {
+        native: "Tile"
+        cpp_name: "TileCpp"
+      }
+      final: true
+      buffer {
+        data: "pixels"
+        shape: "dims"
+      }
+    """, ast)
+    out = '\n'.join(self.m.WrapClass(ast, -1, ''))
+    self.assertIn('\nstatic TileCpp* ThisPtr(PyObject*);\n', out)
+    self.assertIn(
+        'static int buffer_get(PyObject* self, Py_buffer* view, int flags) {\n'
+        '  TileCpp* c = ThisPtr(self);\n'
+        '  if (c == nullptr) return -1;\n'
+        '  return ::clif::buffer::Export(self, view, flags,\n'
+        '    ::clif::MakeStdShared(reinterpret_cast<wrapper*>(self)->cpp),'
+        ' c->pixels(),\n'
+        '    c->dims(), ::clif::buffer::CContiguous(),'
+        ' ::clif::buffer::ElementFormat());\n'
+        '}\n', out)
+    self.assertIn(
+        '  ty->tp_as_buffer->bf_getbuffer = buffer_get;\n'
+        '  ty->tp_as_buffer->bf_releasebuffer = ::clif::buffer::Release;\n',
+        out)
+
   def testVirtualStruct(self):
     self.assertClassEqual("""
       name {
@@ -1890,10 +2501,15 @@ class ClassTest(unittest.TestCase):
         return PyCapsule_New(p, "StructCpp", nullptr);
       }
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"F", (PyCFunction)wrapf_as_F, METH_NOARGS, "F()\n  Calls C++ function\n  void ::StructCpp::f()"},
         {"as_StructCpp", (PyCFunction)as_StructCpp, METH_NOARGS, "Upcast to StructCpp*"},
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -1902,9 +2518,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructCpp", sizeof(StructCpp)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -1944,9 +2564,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_methods = MethodsStaticAlloc;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -1964,9 +2585,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructCpp* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -2141,8 +2769,13 @@ class ClassTest(unittest.TestCase):
         return reinterpret_cast<PyObject*>(it);
       }
 
+      static PyObject* clif_sizeof(PyObject* self) {
+        return ::clif::SizeOf(self, reinterpret_cast<wrapper*>(self)->cpp);
+      }
+
       static PyMethodDef MethodsStaticAlloc[] = {
         {"__reduce_ex__", (PyCFunction)::clif::ReduceExImpl, METH_VARARGS | METH_KEYWORDS, "Helper for pickle."},
+        {"__sizeof__", (PyCFunction)clif_sizeof, METH_NOARGS, "Size of the wrapper and the C++ object it owns"},
         {}
       };
 
@@ -2151,9 +2784,13 @@ class ClassTest(unittest.TestCase):
 
       // Struct __new__
       static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw);
+
+      static ::clif::InstanceCounter instance_counter{"StructCpp", sizeof(StructCpp)};
 
       // Struct __del__
       static void _dtor(PyObject* self) {
+        instance_counter.Destroyed();
         if (reinterpret_cast<wrapper*>(self)->weakrefs) {
           PyObject_ClearWeakRefs(self);
         }
@@ -2192,9 +2829,10 @@ class ClassTest(unittest.TestCase):
         ty->tp_methods = MethodsStaticAlloc;
         ty->tp_init = _ctor;
         ty->tp_alloc = _new;
-        ty->tp_new = PyType_GenericNew;
+        ty->tp_new = _tp_new;
         ty->tp_free = _del;
         ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);
+        ::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);
         return ty;
       }
 
@@ -2211,9 +2849,16 @@ class ClassTest(unittest.TestCase):
         DCHECK(nitems == 0);
         wrapper* wobj = new wrapper;
         PyObject* self = reinterpret_cast<PyObject*>(wobj);
+        instance_counter.Created();
         return PyObject_Init(self, wrapper_Type);
       }
 
+      static PyObject* _tp_new(PyTypeObject* type, PyObject* args, PyObject* kw) {
+        PyObject* self = PyType_GenericNew(type, args, kw);
+        if (self && type->tp_alloc != _new) instance_counter.Created();
+        return self;
+      }
+
       static StructCpp* ThisPtr(PyObject* py) {
         if (Py_TYPE(py) == wrapper_Type) {
           return ::clif::python::Get(reinterpret_cast<wrapper*>(py)->cpp);
@@ -2370,5 +3015,117 @@ class ClassTest(unittest.TestCase):
     """)
 
 
+  def testLazyEnum(self):
+    self.m.lazy_types = True
+    ast = ast_pb2.EnumDecl()
+    text_format.Parse("""
+      name {
+        native: "MyEnum"
+        cpp_name: "myEnum"
+      }
+      members {
+        native: "ONE"
+        cpp_name: "kOne"
+      }
+    """, ast)
+    out = '\n'.join(self.m.WrapEnum(ast, -1, ''))
+    self.assertTrue(out.endswith(textwrap.dedent("""
+      static PyObject* _MyEnum{};  // set by Get_MyEnum()
+
+      // Returns the enum class (borrowed), created on first use.
+      static PyObject* Get_MyEnum() {
+        if (_MyEnum != nullptr) return _MyEnum;
+        PyObject* created = wrapmyEnum();
+        if (created == nullptr) return nullptr;
+        // The Enum call may release the GIL: keep the first class created.
+        if (_MyEnum == nullptr) {
+          _MyEnum = created;
+        } else {
+          Py_DECREF(created);
+        }
+        return _MyEnum;
+      }""")), out)
+    out = '\n'.join(itertools.chain(
+        self.m.GenLazyTypes(),
+        self.m.GenTypesReady(),
+        self.m.GenInitFunction('test.h'),
+        ))+'\n'
+    self.assertMultiLineEqual(out, textwrap.dedent(r"""
+      static const struct {
+        const char* name;
+        PyObject* (*get)();  // Borrowed reference.
+      } kLazyTypes[] = {
+        {"MyEnum", Get_MyEnum},
+      };
+
+      static PyObject* LazyGetAttr(PyObject* module, PyObject* name) {
+        const char* n = PyUnicode_AsUTF8(name);
+        if (n == nullptr) return nullptr;
+        for (const auto& t : kLazyTypes) {
+          if (strcmp(n, t.name) != 0) continue;
+          PyObject* obj = t.get();
+          if (obj == nullptr) return nullptr;
+          // Next lookups find it in the module dict.
+          if (PyObject_SetAttr(module, name, obj) < 0) return nullptr;
+          Py_INCREF(obj);
+          return obj;
+        }
+        PyErr_Format(PyExc_AttributeError, "module '%s' has no attribute '%s'", ThisModuleName, n);
+        return nullptr;
+      }
+
+      static PyObject* LazyDir(PyObject* module, PyObject*) {
+        PyObject* dict = PyModule_GetDict(module);
+        PyObject* names = PyDict_Keys(dict);
+        if (names == nullptr) return nullptr;
+        for (const auto& t : kLazyTypes) {
+          if (PyDict_GetItemString(dict, t.name) != nullptr) continue;
+          PyObject* name = PyUnicode_FromString(t.name);
+          if (name == nullptr || PyList_Append(names, name) < 0) {
+            Py_XDECREF(name);
+            Py_DECREF(names);
+            return nullptr;
+          }
+          Py_DECREF(name);
+        }
+        return names;
+      }
+
+      bool Ready() {
+        return true;
+      }
+
+      static struct PyModuleDef Module = {
+        PyModuleDef_HEAD_INIT,
+        ThisModuleName,
+        "CLIF-generated module for test.h", // module doc
+        -1,  // module keeps state in global variables
+        MethodsStaticAlloc,
+        nullptr,  // m_slots a.k.a. m_reload
+        nullptr,  // m_traverse
+        ClearImportCache  // m_clear
+      };
+
+      PyObject* Init() {
+        PyObject* module = PyModule_Create(&Module);
+        if (!module) return nullptr;
+        {PyObject* em = PyImport_ImportModule("enum");
+         if (em == nullptr) goto err;
+         _Enum = PyObject_GetAttrString(em, "Enum");
+         _IntEnum = PyObject_GetAttrString(em, "IntEnum");
+         Py_DECREF(em);}
+        if (!_Enum || !_IntEnum) {
+          Py_XDECREF(_Enum);
+          Py_XDECREF(_IntEnum);
+          goto err;
+        }
+        return module;
+      err:
+        Py_DECREF(module);
+        return nullptr;
+      }
+    """))
+
+
 if __name__ == '__main__':
   unittest.main()
@@ -68,7 +68,8 @@ class ClassType(TypeDef):
   """C++ class as Python type."""
 
   def __init__(self, cpp_name, pypath, wclass, wtype, wnamespace,
-               can_copy, can_move, can_destruct, virtual, ns=None):
+               can_copy, can_move, can_destruct, virtual, ns=None,
+               interop=False, lazy=False):
     """Register a new class.
 
     Args:
@@ -82,8 +83,12 @@ class ClassType(TypeDef):
       can_destruct: True if C++ class has a public dtor
       virtual: True if class has @virtual method(s) and needs a redirector
       ns: namespace where class defined
+      interop: also accept wrappers of other CLIF backends (see interop.h)
+      lazy: the class type is built on first use (pyclif --lazy_types)
     """
     TypeDef.__init__(self, cpp_name, pypath, ns)
+    self.interop = interop
+    self.lazy = lazy
     self.wrapper_obj = wclass
     self.wrapper_type = wtype
     self.wrapper_ns = wnamespace
@@ -168,6 +173,12 @@ class ClassType(TypeDef):
           yield I+I+'*c = nullptr;'
           yield I+I+'return true;'
           yield I+'}'
+        if arg == 'std::shared_ptr<%s>' and self.interop:
+          # Share ownership with a wrapper of another CLIF backend.
+          yield I+'if (!PyObject_TypeCheck(py, %s)) {' % pytype
+          yield I+I+'if (::clif::interop::GetSharedPtr(py, c)) return true;'
+          yield I+I+'if (PyErr_Occurred()) return false;'
+          yield I+'}'
         yield I+'%s* cpp = %s::%sThisPtr(py);' % (self.cname,
                                                   ns, self.wrapper_ns)
         yield I+'if (cpp == nullptr) return false;'
@@ -211,11 +222,15 @@ class ClassType(TypeDef):
       yield ''
       yield 'PyObject* Clif_PyObjFrom(%s c, py::PostConv unused) {' % (
           arg % self.cname)
-      yield I+'CHECK(%s != nullptr) <<' % pytype  # See cl/307519921.
-      yield I+I+'"---> Function Clif_PyObjFrom(%s) called before " <<' % (
-          self.cname)
-      yield I+I+'%s::ThisModuleName  <<' % ns
-      yield I+I+'" was imported from Python.";'
+      if self.lazy:
+        yield I+'if (!%s::%s::ReadyType()) return nullptr;' % (
+            ns, self.wrapper_ns.split('::', 1)[0])
+      else:
+        yield I+'CHECK(%s != nullptr) <<' % pytype  # See cl/307519921.
+        yield I+I+'"---> Function Clif_PyObjFrom(%s) called before " <<' % (
+            self.cname)
+        yield I+I+'%s::ThisModuleName  <<' % ns
+        yield I+I+'" was imported from Python.";'
       if ptr:
         yield I+'if (c == nullptr) Py_RETURN_NONE;'
       yield I+'PyObject* py = PyType_GenericNew(%s, NULL, NULL);' % pytype
@@ -227,16 +242,55 @@ class ClassType(TypeDef):
       yield I+'return py;'
       yield '}'
 
+  @property
+  def capi_name(self):
+    """Class name prefix of its C-API entries."""
+    return self.pyname.replace('.', '_')
+
+  def CApiEntries(self):
+    """Yield (name, return type, (params), value) for the C-API table.
+
+    The value is valid inside the wrapper namespace.
+    """
+    prefix = self.capi_name + '_'
+    yield (prefix+'ThisPtr', self.cname+'*', '(PyObject*)',
+           self.wrapper_ns+'ThisPtr')
+    from_func = '::%s::Clif_PyObjFrom' % (self.namespace or 'clif').strip(':')
+    for arg, ptr, _ in self._from:
+      if ptr is None: continue
+      params = '(%s, ::clif::py::PostConv)' % (arg % self.cname)
+      yield (prefix+_CAPI_FROM_SUFFIX[arg], 'PyObject*', params,
+             'static_cast<PyObject*(*)%s>(&%s)' % (params, from_func))
+
+
+# C-API table entry names for ClassType._from signatures.
+_CAPI_FROM_SUFFIX = {
+    '%s*': 'FromPtr',
+    'std::shared_ptr<%s>': 'FromShared',
+    'std::unique_ptr<%s>': 'FromUnique',
+    '%s&&': 'FromMove',
+    'const %s&': 'FromCopy',
+    'const %s*': 'FromConstPtr',
+}
+
 
 class EnumType(TypeDef):
   """C++ enum and enum class as Python enum-derived object."""
   _genclifuse = True
 
-  def __init__(self, cpp_name, pyname, pytype, wname, ns=None):
+  def __init__(self, cpp_name, pyname, pytype, wname, ns=None, lazy=False):
     # args like (ns::FooCpp, X.Y.Foo, Enum/IntEnum, X::Y::_Foo)
+    # lazy: the enum class is created on first use (pyclif --lazy_types)
     TypeDef.__init__(self, cpp_name, pyname, ns)
     self.wrapper_type = pytype
     self.wrapper_name = wname
+    self.lazy = lazy
+
+  @property
+  def getter(self):
+    """Function returning the enum class (X::Y::Get_Foo) in lazy mode."""
+    prefix, sep, name = self.wrapper_name.rpartition('::')
+    return prefix + sep + 'Get' + name
 
   def CreateEnum(self, wname, varname, items):
     """Generate a function to create Enum-derived class and a cache var."""
@@ -272,7 +326,25 @@ class EnumType(TypeDef):
     yield I+'return py_enum_class;'
     yield '}'
     yield ''
-    yield 'static PyObject* %s{};  // set by above func in Init()' % varname
+    if not self.lazy:
+      yield 'static PyObject* %s{};  // set by above func in Init()' % varname
+      return
+    getter = 'Get' + varname
+    yield 'static PyObject* %s{};  // set by %s()' % (varname, getter)
+    yield ''
+    yield '// Returns the enum class (borrowed), created on first use.'
+    yield 'static PyObject* %s() {' % getter
+    yield I+'if (%s != nullptr) return %s;' % (varname, varname)
+    yield I+'PyObject* created = %s();' % wname
+    yield I+'if (created == nullptr) return nullptr;'
+    yield I+'// The Enum call may release the GIL: keep the first class created.'
+    yield I+'if (%s == nullptr) {' % varname
+    yield I+I+'%s = created;' % varname
+    yield I+'} else {'
+    yield I+I+'Py_DECREF(created);'
+    yield I+'}'
+    yield I+'return %s;' % varname
+    yield '}'
 
   def GenConverters(self, ns):
     """Generate Clif_PyObjAs() and Clif_PyObjFrom() definitions."""
@@ -283,6 +355,12 @@ class EnumType(TypeDef):
     yield ''
     yield 'bool Clif_PyObjAs(PyObject* py, %s* c) {' % self.cname
     yield I+'CHECK(c != nullptr);'
+    yield I+('::clif::profile::ConversionTimer timer(typeid(*c), '
+             '::clif::profile::Direction::kToCpp);')
+    if self.lazy:
+      yield I+'PyObject* enum_class = %s::%s();' % (ns, self.getter)
+      yield I+'if (enum_class == nullptr) return false;'
+      wname = 'enum_class'
     yield I+'if (!PyObject_IsInstance(py, %s)) {' % wname
     yield I+I+('PyErr_Format(PyExc_TypeError, "expecting enum {}, got %s %s", '
                'ClassName(py), ClassType(py));').format(self.pyname)
@@ -297,6 +375,12 @@ class EnumType(TypeDef):
     yield '}'
     yield ''
     yield 'PyObject* Clif_PyObjFrom(const %s& c, py::PostConv) {' % self.cname
+    yield I+('::clif::profile::ConversionTimer timer(typeid(c), '
+             '::clif::profile::Direction::kToPy);')
+    if self.lazy:
+      yield I+'PyObject* enum_class = %s::%s();' % (ns, self.getter)
+      yield I+'if (enum_class == nullptr) return nullptr;'
+      wname = 'enum_class'
     yield I+'return PyObject_CallFunctionObjArgs(%s, PyLong_FromLong(' % wname
     yield I+I+I+AsType(EnumIntType(self.cname), 'c')+'), nullptr);'
     yield '}'
@@ -337,6 +421,8 @@ class ProtoType(TypeDef):
     yield ''
     yield 'bool Clif_PyObjAs(PyObject* py, %s* c) {' % ctype
     yield I+'CHECK(c != nullptr);'
+    yield I+('::clif::profile::ConversionTimer timer(typeid(*c), '
+             '::clif::profile::Direction::kToCpp);')
     yield I+'PyObject* type = ImportFQName("%s");' % import_name
     yield I+('if (!::clif::proto::TypeCheck(py, type, "%s", "%s") ) {'
              % (el_name, self.pyname))
@@ -349,6 +435,7 @@ class ProtoType(TypeDef):
     yield I+'}'
     yield I+'PyObject* ser = ::clif::proto::Serialize(py);'
     yield I+'if (ser == nullptr) return false;'
+    yield I+'timer.AddItems(PyBytes_GET_SIZE(ser));'
     yield I + (
         'bool ok = c->ParsePartialFromArray('
         'PyBytes_AS_STRING(ser), static_cast<int>(PyBytes_GET_SIZE(ser)));')
@@ -466,13 +553,16 @@ class CapsuleType(TypeDef):
     yield '}'
 
 
-def GenThisPointerFunc(cname, w='wrapper', final=False):
+def GenThisPointerFunc(cname, w='wrapper', final=False, interop=False,
+                       lazy=False):
   """Generate "to this*" conversion (inside wrapper namespace).
 
   Args:
     cname: FQ class name (::multiday::Metric)
     w: pyext.Context.wrapper_class_name
     final: generate version for a final class wrapper
+    interop: also accept wrappers of other CLIF backends (see interop.h)
+    lazy: build the class type if not yet done (pyclif --lazy_types)
   Yields:
     ThisPtr() function source
   """
@@ -484,6 +574,8 @@ def GenThisPointerFunc(cname, w='wrapper', final=False):
   yield I+'if (Py_TYPE(py) == %s) {' % t
   yield I+I+return_this_cpp
   yield I+'}'
+  if lazy:
+    yield I+'if (!ReadyType()) return nullptr;'
   if final:
     _I=''  # pylint: disable=bad-whitespace,invalid-name
   else:
@@ -499,6 +591,12 @@ def GenThisPointerFunc(cname, w='wrapper', final=False):
                'ClassName(py), ClassType(py));').format(cname)
     yield I+'} else {'
     _I=I  # pylint: disable=bad-whitespace,invalid-name
+  if interop:
+    # Owned by the other wrapper, valid while the caller holds py.
+    yield _I+I+'std::shared_ptr<%s> foreign;' % cname
+    yield _I+I+('if (::clif::interop::GetSharedPtr(py, &foreign))'
+                ' return foreign.get();')
+    yield _I+I+'if (PyErr_Occurred()) return nullptr;'
   yield _I+I+('PyErr_Format(PyExc_TypeError, "expecting %s instance, got %s %s"'
               ', {}->tp_name, ClassName(py), ClassType(py));'.format(t))
   if not final:
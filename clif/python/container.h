@@ -0,0 +1,211 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_CONTAINER_H_
+#define CLIF_PYTHON_CONTAINER_H_
+
+/*
+Sequence and mapping protocol slots of a class wrapped with the .clif
+@container_protocol decorator, calling its C++ members directly:
+
+  sq_length     size()
+  sq_item       operator[](size_t) (with size()), unless the class has a
+                key_type
+  mp_subscript  find(key)->second, if the class has a key_type and a
+                mapped_type
+  sq_contains   contains(key), count(key) or find(key) != end(), if the class
+                has a key_type
+
+SqLength<C, ThisPtr>() etc. return the slot function, or nullptr when C lacks
+the members, so that the slot is left to Python's defaults.
+
+A Python key that does not convert to key_type is not in the container: `in`
+returns False and [] raises KeyError.
+*/
+
+#include <Python.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "clif/python/types.h"
+
+namespace clif {
+namespace container {
+
+template <typename C>
+using ThisPtrFunc = C* (*)(PyObject*);
+
+// Returns 1 and sets *key if |py| converts to a key, 0 if it does not and -1
+// on other errors.
+template <typename K>
+int AsKey(PyObject* py, K* key) {
+  if (Clif_PyObjAs(py, key)) return 1;
+  if (PyErr_ExceptionMatches(PyExc_TypeError) ||
+      PyErr_ExceptionMatches(PyExc_ValueError) ||
+      PyErr_ExceptionMatches(PyExc_OverflowError)) {
+    PyErr_Clear();
+    return 0;
+  }
+  return -1;
+}
+
+namespace internal {
+
+template <typename C, typename = void>
+struct HasSize : std::false_type {};
+template <typename C>
+struct HasSize<C, std::void_t<decltype(std::declval<const C&>().size())>>
+    : std::true_type {};
+
+template <typename C, typename = void>
+struct HasIndex : std::false_type {};
+template <typename C>
+struct HasIndex<C, std::void_t<decltype(std::declval<C&>()[std::size_t{}])>>
+    : std::true_type {};
+
+template <typename C, typename = void>
+struct HasKeyType : std::false_type {};
+template <typename C>
+struct HasKeyType<C, std::void_t<typename C::key_type>> : std::true_type {};
+
+template <typename C, typename = void>
+struct HasMappedType : std::false_type {};
+template <typename C>
+struct HasMappedType<C, std::void_t<typename C::mapped_type>>
+    : std::true_type {};
+
+template <typename C>
+using Key = const typename C::key_type&;
+
+template <typename C, typename = void>
+struct HasContains : std::false_type {};
+template <typename C>
+struct HasContains<C, std::void_t<decltype(static_cast<bool>(
+                          std::declval<const C&>().contains(
+                              std::declval<Key<C>>())))>>
+    : std::true_type {};
+
+template <typename C, typename = void>
+struct HasCount : std::false_type {};
+template <typename C>
+struct HasCount<C, std::void_t<decltype(std::declval<const C&>().count(
+                       std::declval<Key<C>>()) > 0)>> : std::true_type {};
+
+template <typename C, typename = void>
+struct HasFind : std::false_type {};
+template <typename C>
+struct HasFind<C, std::void_t<decltype(std::declval<C&>().find(
+                                           std::declval<Key<C>>()) !=
+                                       std::declval<C&>().end())>>
+    : std::true_type {};
+
+template <typename C, ThisPtrFunc<C> This>
+Py_ssize_t Length(PyObject* self) {
+  C* c = This(self);
+  if (c == nullptr) return -1;
+  return static_cast<Py_ssize_t>(c->size());
+}
+
+template <typename C, ThisPtrFunc<C> This>
+PyObject* Item(PyObject* self, Py_ssize_t i) {
+  C* c = This(self);
+  if (c == nullptr) return nullptr;
+  // Python adds the length to negative indices.
+  if (i < 0 || static_cast<std::size_t>(i) >= c->size()) {
+    PyErr_SetString(PyExc_IndexError, "index out of range");
+    return nullptr;
+  }
+  return Clif_PyObjFrom((*c)[static_cast<std::size_t>(i)], {});
+}
+
+template <typename C, ThisPtrFunc<C> This>
+PyObject* Subscript(PyObject* self, PyObject* py_key) {
+  C* c = This(self);
+  if (c == nullptr) return nullptr;
+  typename C::key_type key;
+  int is_key = AsKey(py_key, &key);
+  if (is_key < 0) return nullptr;
+  if (is_key) {
+    auto it = c->find(key);
+    if (it != c->end()) return Clif_PyObjFrom(it->second, {});
+  }
+  PyErr_SetObject(PyExc_KeyError, py_key);
+  return nullptr;
+}
+
+template <typename C, ThisPtrFunc<C> This>
+int Contains(PyObject* self, PyObject* py_key) {
+  C* c = This(self);
+  if (c == nullptr) return -1;
+  typename C::key_type key;
+  int is_key = AsKey(py_key, &key);
+  if (is_key <= 0) return is_key;
+  if constexpr (HasContains<C>::value) {
+    return static_cast<const C*>(c)->contains(key) ? 1 : 0;
+  } else if constexpr (HasCount<C>::value) {
+    return static_cast<const C*>(c)->count(key) > 0 ? 1 : 0;
+  } else {
+    return c->find(key) != c->end() ? 1 : 0;
+  }
+}
+
+}  // namespace internal
+
+template <typename C, ThisPtrFunc<C> This>
+constexpr lenfunc SqLength() {
+  if constexpr (internal::HasSize<C>::value) {
+    return &internal::Length<C, This>;
+  } else {
+    return nullptr;
+  }
+}
+
+template <typename C, ThisPtrFunc<C> This>
+constexpr ssizeargfunc SqItem() {
+  if constexpr (internal::HasSize<C>::value && internal::HasIndex<C>::value &&
+                !internal::HasKeyType<C>::value) {
+    return &internal::Item<C, This>;
+  } else {
+    return nullptr;
+  }
+}
+
+template <typename C, ThisPtrFunc<C> This>
+constexpr binaryfunc MpSubscript() {
+  if constexpr (internal::HasKeyType<C>::value &&
+                internal::HasMappedType<C>::value &&
+                internal::HasFind<C>::value) {
+    return &internal::Subscript<C, This>;
+  } else {
+    return nullptr;
+  }
+}
+
+template <typename C, ThisPtrFunc<C> This>
+constexpr objobjproc SqContains() {
+  if constexpr (internal::HasContains<C>::value ||
+                internal::HasCount<C>::value || internal::HasFind<C>::value) {
+    return &internal::Contains<C, This>;
+  } else {
+    return nullptr;
+  }
+}
+
+}  // namespace container
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_CONTAINER_H_
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "clif/python/container.h"
+
+#include <Python.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace clif {
+namespace container {
+namespace {
+
+class ContainerTest : public ::testing::Test {
+ protected:
+  ContainerTest() { Py_Initialize(); }
+};
+
+// Containers reached from any PyObject*, in place of wrapped instances.
+struct Sequence {
+  std::size_t size() const { return 3; }
+  int operator[](std::size_t i) const { return static_cast<int>(10 * i); }
+};
+
+Sequence* SequencePtr(PyObject*) {
+  static Sequence* s = new Sequence;
+  return s;
+}
+
+using Map = std::map<std::string, int>;
+
+Map* MapPtr(PyObject*) {
+  static Map* m = new Map{{"a", 1}, {"b", 2}};
+  return m;
+}
+
+using Set = std::set<int>;
+
+Set* SetPtr(PyObject*) {
+  static Set* s = new Set{1, 2};
+  return s;
+}
+
+struct NotAContainer {};
+
+NotAContainer* NotAContainerPtr(PyObject*) { return nullptr; }
+
+TEST_F(ContainerTest, Sequence) {
+  lenfunc len = SqLength<Sequence, SequencePtr>();
+  ssizeargfunc item = SqItem<Sequence, SequencePtr>();
+  ASSERT_NE(len, nullptr);
+  ASSERT_NE(item, nullptr);
+  EXPECT_EQ(len(Py_None), 3);
+  PyObject* value = item(Py_None, 2);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(PyLong_AsLong(value), 20);
+  Py_DECREF(value);
+  EXPECT_EQ(item(Py_None, 3), nullptr);
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_IndexError));
+  PyErr_Clear();
+  binaryfunc subscript = MpSubscript<Sequence, SequencePtr>();
+  objobjproc contains = SqContains<Sequence, SequencePtr>();
+  EXPECT_EQ(subscript, nullptr);
+  EXPECT_EQ(contains, nullptr);
+}
+
+TEST_F(ContainerTest, Mapping) {
+  lenfunc len = SqLength<Map, MapPtr>();
+  ssizeargfunc item = SqItem<Map, MapPtr>();
+  binaryfunc subscript = MpSubscript<Map, MapPtr>();
+  objobjproc contains = SqContains<Map, MapPtr>();
+  ASSERT_NE(len, nullptr);
+  EXPECT_EQ(item, nullptr);
+  ASSERT_NE(subscript, nullptr);
+  ASSERT_NE(contains, nullptr);
+  EXPECT_EQ(len(Py_None), 2);
+  PyObject* a = PyUnicode_FromString("a");
+  PyObject* z = PyUnicode_FromString("z");
+  PyObject* value = subscript(Py_None, a);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(PyLong_AsLong(value), 1);
+  Py_DECREF(value);
+  EXPECT_EQ(subscript(Py_None, z), nullptr);
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_KeyError));
+  PyErr_Clear();
+  // Not a string, so not a key.
+  EXPECT_EQ(subscript(Py_None, Py_None), nullptr);
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_KeyError));
+  PyErr_Clear();
+  EXPECT_EQ(contains(Py_None, a), 1);
+  EXPECT_EQ(contains(Py_None, z), 0);
+  EXPECT_EQ(contains(Py_None, Py_None), 0);
+  EXPECT_EQ(PyErr_Occurred(), nullptr);
+  Py_DECREF(a);
+  Py_DECREF(z);
+}
+
+TEST_F(ContainerTest, Set) {
+  lenfunc len = SqLength<Set, SetPtr>();
+  ssizeargfunc item = SqItem<Set, SetPtr>();
+  binaryfunc subscript = MpSubscript<Set, SetPtr>();
+  objobjproc contains = SqContains<Set, SetPtr>();
+  ASSERT_NE(len, nullptr);
+  EXPECT_EQ(item, nullptr);
+  EXPECT_EQ(subscript, nullptr);
+  ASSERT_NE(contains, nullptr);
+  EXPECT_EQ(len(Py_None), 2);
+  PyObject* one = PyLong_FromLong(1);
+  PyObject* three = PyLong_FromLong(3);
+  EXPECT_EQ(contains(Py_None, one), 1);
+  EXPECT_EQ(contains(Py_None, three), 0);
+  Py_DECREF(one);
+  Py_DECREF(three);
+}
+
+TEST_F(ContainerTest, NotAContainer) {
+  lenfunc len = SqLength<NotAContainer, NotAContainerPtr>();
+  ssizeargfunc item = SqItem<NotAContainer, NotAContainerPtr>();
+  binaryfunc subscript = MpSubscript<NotAContainer, NotAContainerPtr>();
+  objobjproc contains = SqContains<NotAContainer, NotAContainerPtr>();
+  EXPECT_EQ(len, nullptr);
+  EXPECT_EQ(item, nullptr);
+  EXPECT_EQ(subscript, nullptr);
+  EXPECT_EQ(contains, nullptr);
+}
+
+}  // namespace
+}  // namespace container
+}  // namespace clif
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Python.h>
+
+#include "clif/python/conversion_profile.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>  // NOLINT: build/c++11
+#include <utility>
+
+#include "clif/python/runtime.h"
+
+namespace clif {
+namespace profile {
+namespace {
+
+// Bump if Registry changes, extensions built with another layout then use
+// their own registry.
+constexpr char kRegistryName[] = "__clif_conversion_profile_v1__";
+
+struct Totals {
+  long long calls = 0;  // NOLINT: runtime/int
+  long long items = 0;  // NOLINT: runtime/int
+  long long nanos = 0;  // NOLINT: runtime/int
+};
+
+// Process-wide (see ProcessWideObject).
+struct Registry {
+  std::atomic<bool> enabled{false};
+  std::mutex mu;
+  // Keyed by mangled name, std::type_info objects are not unique across
+  // extensions.
+  std::map<std::pair<std::string, Direction>, Totals> totals;
+};
+
+Registry* GetRegistry() {
+  static Registry* registry = static_cast<Registry*>(ProcessWideObject(
+      kRegistryName, [] { return static_cast<void*>(new Registry); }));
+  return registry;
+}
+
+}  // namespace
+
+void Enable(bool on) {
+  GetRegistry()->enabled.store(on, std::memory_order_relaxed);
+}
+
+bool IsEnabled() { return Enabled(); }
+
+void Reset() {
+  Registry* r = GetRegistry();
+  std::lock_guard<std::mutex> lock(r->mu);
+  r->totals.clear();
+}
+
+std::vector<ConversionStats> Snapshot() {
+  Registry* r = GetRegistry();
+  std::vector<ConversionStats> stats;
+  {
+    std::lock_guard<std::mutex> lock(r->mu);
+    stats.reserve(r->totals.size());
+    for (const auto& it : r->totals) {
+      ConversionStats s;
+      s.type = it.first.first;
+      s.direction = it.first.second == Direction::kToCpp ? "py->c++"
+                                                          : "c++->py";
+      s.calls = it.second.calls;
+      s.items = it.second.items;
+      s.nanos = it.second.nanos;
+      stats.push_back(std::move(s));
+    }
+  }
+  for (auto& s : stats) s.type = python::Demangle(s.type.c_str());
+  std::sort(stats.begin(), stats.end(),
+            [](const ConversionStats& a, const ConversionStats& b) {
+              return a.nanos > b.nanos;
+            });
+  return stats;
+}
+
+namespace internal {
+
+const std::atomic<bool>* SharedEnabledFlag() {
+  return &GetRegistry()->enabled;
+}
+
+void Record(const std::type_info& type, Direction direction,
+            long long nanos, long long items) {  // NOLINT: runtime/int
+  Registry* r = GetRegistry();
+  std::lock_guard<std::mutex> lock(r->mu);
+  Totals& t = r->totals[{type.name(), direction}];
+  ++t.calls;
+  t.items += items;
+  t.nanos += nanos;
+}
+
+}  // namespace internal
+}  // namespace profile
+}  // namespace clif
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_CONVERSION_PROFILE_H_
+#define CLIF_PYTHON_CONVERSION_PROFILE_H_
+
+/*
+Opt-in profiler of Python <-> C++ conversions by C++ type.
+
+When enabled (from Python with clif.python.utils.conversion_profile.Enable)
+the container, string and proto converters record their wall time and
+item count, aggregated process-wide across all CLIF modules. Times are
+inclusive: converting a std::vector<std::string> is also counted for every
+std::string element. When disabled each instrumented conversion only checks
+a flag.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace clif {
+namespace profile {
+
+enum class Direction { kToCpp, kToPy };
+
+// Aggregated conversions of one C++ type in one direction.
+struct ConversionStats {
+  std::string type;       // Demangled C++ type name.
+  std::string direction;  // "py->c++" or "c++->py".
+  long long calls = 0;    // NOLINT: runtime/int
+  // Container elements, string bytes or serialized proto bytes.
+  long long items = 0;    // NOLINT: runtime/int
+  long long nanos = 0;    // NOLINT: runtime/int
+};
+
+// Starts (on=true) or stops recording conversions.
+void Enable(bool on);
+bool IsEnabled();
+// Drops the recorded conversions.
+void Reset();
+// Returns the recorded conversions, most expensive first.
+std::vector<ConversionStats> Snapshot();
+
+namespace internal {
+// The flag shared by all CLIF extensions in the process. Needs the GIL.
+const std::atomic<bool>* SharedEnabledFlag();
+void Record(const std::type_info& type, Direction direction,
+            long long nanos, long long items);  // NOLINT: runtime/int
+}  // namespace internal
+
+inline bool Enabled() {
+  static const std::atomic<bool>* enabled = internal::SharedEnabledFlag();
+  return enabled->load(std::memory_order_relaxed);
+}
+
+// Records the conversion of one value of |type| done in its scope.
+class ConversionTimer {
+ public:
+  ConversionTimer(const std::type_info& type, Direction direction)
+      : type_(Enabled() ? &type : nullptr), direction_(direction) {
+    if (type_) start_ = std::chrono::steady_clock::now();
+  }
+  ~ConversionTimer() {
+    if (type_) {
+      internal::Record(*type_, direction_,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start_).count(),
+                       items_);
+    }
+  }
+  ConversionTimer(const ConversionTimer&) = delete;
+  ConversionTimer& operator=(const ConversionTimer&) = delete;
+
+  void AddItems(long long n) { items_ += n; }  // NOLINT: runtime/int
+
+ private:
+  const std::type_info* type_;
+  Direction direction_;
+  long long items_ = 0;  // NOLINT: runtime/int
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace profile
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_CONVERSION_PROFILE_H_
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "clif/python/conversion_profile.h"
+
+#include <Python.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "clif/python/stltypes.h"
+
+namespace clif {
+namespace profile {
+namespace {
+
+class ConversionProfileTest : public ::testing::Test {
+ protected:
+  ConversionProfileTest() {
+    Py_Initialize();
+    Reset();
+  }
+  ~ConversionProfileTest() override {
+    Enable(false);
+    Reset();
+  }
+
+  // Converts |v| to a Python list and back.
+  static void RoundTrip(const std::vector<int>& v) {
+    PyObject* py = Clif_PyObjFrom(v, {});
+    ASSERT_NE(py, nullptr);
+    std::vector<int> back;
+    EXPECT_TRUE(Clif_PyObjAs(py, &back));
+    EXPECT_EQ(back, v);
+    Py_DECREF(py);
+  }
+
+  // The recorded conversions of std::vector<int> in |direction|.
+  static const ConversionStats* VectorStats(
+      const std::vector<ConversionStats>& stats, const std::string& direction) {
+    for (const auto& s : stats) {
+      if (s.type.find("vector<int") != std::string::npos &&
+          s.direction == direction) {
+        return &s;
+      }
+    }
+    return nullptr;
+  }
+};
+
+TEST_F(ConversionProfileTest, Enable) {
+  EXPECT_FALSE(IsEnabled());
+  Enable(true);
+  EXPECT_TRUE(IsEnabled());
+  EXPECT_TRUE(Enabled());
+  Enable(false);
+  EXPECT_FALSE(IsEnabled());
+}
+
+TEST_F(ConversionProfileTest, RecordsContainerConversions) {
+  Enable(true);
+  RoundTrip({1, 2, 3});
+  RoundTrip({4, 5});
+  std::vector<ConversionStats> stats = Snapshot();
+  const ConversionStats* to_py = VectorStats(stats, "c++->py");
+  ASSERT_NE(to_py, nullptr);
+  EXPECT_EQ(to_py->calls, 2);
+  EXPECT_EQ(to_py->items, 5);
+  EXPECT_GE(to_py->nanos, 0);
+  const ConversionStats* to_cpp = VectorStats(stats, "py->c++");
+  ASSERT_NE(to_cpp, nullptr);
+  EXPECT_EQ(to_cpp->calls, 2);
+  EXPECT_EQ(to_cpp->items, 5);
+  // Most expensive first.
+  for (size_t i = 1; i < stats.size(); ++i) {
+    EXPECT_GE(stats[i - 1].nanos, stats[i].nanos);
+  }
+  Reset();
+  EXPECT_TRUE(Snapshot().empty());
+}
+
+TEST_F(ConversionProfileTest, DisabledRecordsNothing) {
+  RoundTrip({1, 2, 3});
+  EXPECT_TRUE(Snapshot().empty());
+  {
+    ConversionTimer timer(typeid(int), Direction::kToPy);
+    timer.AddItems(1);
+  }
+  EXPECT_TRUE(Snapshot().empty());
+}
+
+}  // namespace
+}  // namespace profile
+}  // namespace clif
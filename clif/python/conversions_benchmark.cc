@@ -0,0 +1,316 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the Clif_PyObjFrom (ToPy) and Clif_PyObjAs (ToCpp) runtime
+// conversions of types.h and stltypes.h, in an embedded interpreter.
+//
+// Besides the time per iteration each benchmark reports:
+//   ns/element      time per converted element (container item, or value)
+//   allocs/element  C++ (operator new) and Python (PyMem/PyObject) heap
+//                   allocations per converted element
+//
+// $> pyClifConversionsBenchmark --benchmark_filter='ToCpp<IntVector>'
+
+#include <Python.h>
+
+#include <chrono>  // NOLINT: build/c++11
+#include <complex>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <new>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/base/config.h"
+#include "absl/numeric/int128.h"
+#include "clif/python/stltypes.h"
+#include "clif/python/types.h"
+
+namespace {
+
+long long allocations = 0;  // NOLINT: runtime/int
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace clif {
+namespace {
+
+// Counting wrappers of the Python allocators, see InstallPyMemCounters.
+PyMemAllocatorEx py_mem, py_obj;
+
+void* CountMalloc(void* ctx, std::size_t size) {
+  ++allocations;
+  auto* a = static_cast<PyMemAllocatorEx*>(ctx);
+  return a->malloc(a->ctx, size);
+}
+void* CountCalloc(void* ctx, std::size_t nelem, std::size_t elsize) {
+  ++allocations;
+  auto* a = static_cast<PyMemAllocatorEx*>(ctx);
+  return a->calloc(a->ctx, nelem, elsize);
+}
+void* ForwardRealloc(void* ctx, void* ptr, std::size_t size) {
+  auto* a = static_cast<PyMemAllocatorEx*>(ctx);
+  return a->realloc(a->ctx, ptr, size);
+}
+void ForwardFree(void* ctx, void* ptr) {
+  auto* a = static_cast<PyMemAllocatorEx*>(ctx);
+  a->free(a->ctx, ptr);
+}
+
+void InstallPyMemCounters() {
+  for (auto domain : {PYMEM_DOMAIN_MEM, PYMEM_DOMAIN_OBJ}) {
+    PyMemAllocatorEx* original =
+        domain == PYMEM_DOMAIN_MEM ? &py_mem : &py_obj;
+    PyMem_GetAllocator(domain, original);
+    PyMemAllocatorEx counting = {original, CountMalloc, CountCalloc,
+                                 ForwardRealloc, ForwardFree};
+    PyMem_SetAllocator(domain, &counting);
+  }
+}
+
+// Sample<T>::Make(n) returns a T with n elements (or of n bytes for strings),
+// Sample<T>::Distinct(i) the i-th of distinct values to fill containers.
+template <typename T>
+struct Sample {
+  static T Make(int n) { return Distinct(n); }
+  static T Distinct(int i) { return static_cast<T>(i); }
+  static int Elements(int) { return 1; }
+};
+
+template <>
+struct Sample<std::string> {
+  static std::string Make(int n) { return std::string(n, 'x'); }
+  static std::string Distinct(int i) { return "item" + std::to_string(i); }
+  static int Elements(int) { return 1; }
+};
+
+template <>
+struct Sample<absl::int128> {
+  static absl::int128 Make(int n) { return absl::MakeInt128(n, 1); }
+  static int Elements(int) { return 1; }
+};
+
+template <>
+struct Sample<std::complex<double>> {
+  static std::complex<double> Make(int n) { return {0.5, 1.0 * n}; }
+  static int Elements(int) { return 1; }
+};
+
+#ifdef ABSL_HAVE_STD_OPTIONAL
+template <typename T>
+struct Sample<std::optional<T>> {
+  static std::optional<T> Make(int n) { return Sample<T>::Make(n); }
+  static int Elements(int) { return 1; }
+};
+#endif
+
+#ifdef ABSL_HAVE_STD_VARIANT
+template <typename... T>
+struct Sample<std::variant<T...>> {
+  // The last alternative, so that conversion to C++ tries all of them.
+  using Last = typename std::tuple_element<
+      sizeof...(T) - 1, std::tuple<T...>>::type;
+  static std::variant<T...> Make(int n) { return Sample<Last>::Make(n); }
+  static int Elements(int) { return 1; }
+};
+#endif
+
+// Containers with n elements.
+template <typename C>
+struct ContainerSample {
+  static C Make(int n) {
+    C c;
+    for (int i = 0; i < n; ++i) Add(&c, i);
+    return c;
+  }
+  static int Elements(int n) { return n; }
+
+ private:
+  template <typename T>
+  static void Add(std::vector<T>* c, int i) {
+    c->push_back(Sample<T>::Distinct(i));
+  }
+  template <typename T>
+  static void Add(std::set<T>* c, int i) {
+    c->insert(Sample<T>::Distinct(i));
+  }
+  template <typename T>
+  static void Add(std::unordered_set<T>* c, int i) {
+    c->insert(Sample<T>::Distinct(i));
+  }
+  template <typename K, typename V>
+  static void Add(std::map<K, V>* c, int i) {
+    c->emplace(Sample<K>::Distinct(i), Sample<V>::Distinct(i));
+  }
+  template <typename K, typename V>
+  static void Add(std::unordered_map<K, V>* c, int i) {
+    c->emplace(Sample<K>::Distinct(i), Sample<V>::Distinct(i));
+  }
+};
+
+template <typename T>
+struct Sample<std::vector<T>> : ContainerSample<std::vector<T>> {};
+template <typename T>
+struct Sample<std::set<T>> : ContainerSample<std::set<T>> {};
+template <typename T>
+struct Sample<std::unordered_set<T>> : ContainerSample<std::unordered_set<T>> {
+};
+template <typename K, typename V>
+struct Sample<std::map<K, V>> : ContainerSample<std::map<K, V>> {};
+template <typename K, typename V>
+struct Sample<std::unordered_map<K, V>>
+    : ContainerSample<std::unordered_map<K, V>> {};
+
+// Measures the benchmark loop run after its construction.
+class Meter {
+ public:
+  Meter()
+      : allocations_(allocations), start_(std::chrono::steady_clock::now()) {}
+
+  // Sets the counters for |elements| converted per iteration.
+  void Report(benchmark::State& state, int elements) const {
+    const double nanos = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start_).count();
+    const double n = static_cast<double>(elements) * state.iterations();
+    state.SetItemsProcessed(static_cast<int64_t>(n));
+    if (n == 0) return;
+    state.counters["ns/element"] = nanos / n;
+    state.counters["allocs/element"] = (allocations - allocations_) / n;
+  }
+
+ private:
+  long long allocations_;  // NOLINT: runtime/int
+  std::chrono::steady_clock::time_point start_;
+};
+
+template <typename T>
+void BM_ToPy(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const T value = Sample<T>::Make(n);
+  Meter meter;
+  for (auto _ : state) {
+    PyObject* py = Clif_PyObjFrom(value, {});
+    if (py == nullptr) {
+      state.SkipWithError(python::ExcStr().c_str());
+      break;
+    }
+    Py_DECREF(py);
+  }
+  meter.Report(state, Sample<T>::Elements(n));
+}
+
+template <typename T>
+void BM_ToCpp(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  PyObject* py = Clif_PyObjFrom(Sample<T>::Make(n), {});
+  Meter meter;
+  for (auto _ : state) {
+    T value;
+    if (!Clif_PyObjAs(py, &value)) {
+      state.SkipWithError(python::ExcStr().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  meter.Report(state, Sample<T>::Elements(n));
+  Py_XDECREF(py);
+}
+
+// A C++ call of a Python callable passed as std::function.
+void BM_Callback(benchmark::State& state) {
+  PyObject* globals = PyDict_New();
+  PyObject* callable = PyRun_String("lambda x: x", Py_eval_input, globals,
+                                    globals);
+  std::function<int(int)> f;
+  if (callable == nullptr || !Clif_PyObjAs(callable, &f)) {
+    state.SkipWithError(python::ExcStr().c_str());
+  }
+  Meter meter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f(1));
+  }
+  meter.Report(state, 1);
+  f = nullptr;
+  Py_XDECREF(callable);
+  Py_DECREF(globals);
+}
+
+using Complex = std::complex<double>;
+using IntVector = std::vector<int>;
+using DoubleVector = std::vector<double>;
+using StringVector = std::vector<std::string>;
+using IntSet = std::set<int>;
+using StringUnorderedSet = std::unordered_set<std::string>;
+using IntIntMap = std::map<int, int>;
+using StringIntUnorderedMap = std::unordered_map<std::string, int>;
+
+#define CLIF_CONVERSION_BENCHMARK(T)  \
+  BENCHMARK_TEMPLATE(BM_ToPy, T)->Arg(1); \
+  BENCHMARK_TEMPLATE(BM_ToCpp, T)->Arg(1)
+#define CLIF_SIZED_CONVERSION_BENCHMARK(T, max)                          \
+  BENCHMARK_TEMPLATE(BM_ToPy, T)->RangeMultiplier(16)->Range(1, max);  \
+  BENCHMARK_TEMPLATE(BM_ToCpp, T)->RangeMultiplier(16)->Range(1, max)
+
+CLIF_CONVERSION_BENCHMARK(bool);
+CLIF_CONVERSION_BENCHMARK(int);
+CLIF_CONVERSION_BENCHMARK(long long);  // NOLINT: runtime/int
+CLIF_CONVERSION_BENCHMARK(double);
+CLIF_CONVERSION_BENCHMARK(absl::int128);
+CLIF_CONVERSION_BENCHMARK(Complex);
+CLIF_SIZED_CONVERSION_BENCHMARK(std::string, 64 << 10);
+#ifdef ABSL_HAVE_STD_OPTIONAL
+using OptionalInt = std::optional<int>;
+CLIF_CONVERSION_BENCHMARK(OptionalInt);
+#endif
+#ifdef ABSL_HAVE_STD_VARIANT
+using IntOrString = std::variant<int, std::string>;
+CLIF_SIZED_CONVERSION_BENCHMARK(IntOrString, 1 << 10);
+#endif
+CLIF_SIZED_CONVERSION_BENCHMARK(IntVector, 64 << 10);
+CLIF_SIZED_CONVERSION_BENCHMARK(DoubleVector, 64 << 10);
+CLIF_SIZED_CONVERSION_BENCHMARK(StringVector, 64 << 10);
+CLIF_SIZED_CONVERSION_BENCHMARK(IntSet, 4 << 10);
+CLIF_SIZED_CONVERSION_BENCHMARK(StringUnorderedSet, 4 << 10);
+CLIF_SIZED_CONVERSION_BENCHMARK(IntIntMap, 4 << 10);
+CLIF_SIZED_CONVERSION_BENCHMARK(StringIntUnorderedMap, 4 << 10);
+BENCHMARK(BM_Callback);
+
+}  // namespace
+}  // namespace clif
+
+int main(int argc, char** argv) {
+  Py_InitializeEx(0);
+  clif::InstallPyMemCounters();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
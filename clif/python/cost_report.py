@@ -0,0 +1,264 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generation-time conversion cost report.
+
+Given a matched AST proto, GenerateReport() yields a human readable report
+listing for each wrapped function, method and property:
+- every Python <-> C++ conversion the generated wrapper performs,
+- a rough estimate of its copy and allocation complexity,
+- whether the C++ call runs with the GIL released,
+- HINT lines for patterns with a known cheaper alternative.
+
+Complexity uses n, m, k for the sizes of nested containers, len for the
+length of a string and size for the serialized size of a proto message.
+"""
+
+import os
+import re
+
+from clif.python import astutils
+
+# ProtoType.GenHeader emits this declaration for every wrapped proto message.
+_PROTO_FROM = re.compile(
+    r'PyObject\* Clif_PyObjFrom\(std::unique_ptr<const (?P<cname>.+)>,'
+    r' py::PostConv\);')
+_STRING_TYPES = ('std::string', 'absl::string_view', 'std::string_view',
+                 'absl::Cord')
+_SMART_PTRS = ('std::shared_ptr<', 'std::unique_ptr<')
+_CONTAINER_SIZES = 'nmk'
+_TO_CPP = 'py->c++'
+_TO_PY = 'c++->py'
+
+
+def ProtoTypesFromIncludes(headers, include_paths):
+  """Return C++ names of proto messages declared in CLIF-generated headers."""
+  protos = set()
+  for hdr in headers:
+    for root in include_paths:
+      try:
+        with open(os.path.join(root, hdr)) as f:
+          for line in f:
+            m = _PROTO_FROM.match(line)
+            if m:
+              protos.add(_BareType(m.group('cname')))
+        break
+      except IOError:
+        pass
+  return protos
+
+
+def _BareType(cpp_type):
+  """Drop cv-qualifiers, references and the global namespace prefix."""
+  t = cpp_type.strip()
+  if t.startswith('const '):
+    t = t[len('const '):]
+  t = t.rstrip('&* ')
+  if t.endswith(' const'):
+    t = t[:-len(' const')]
+  return t.lstrip(':')
+
+
+class Cost(object):
+  """Copy/allocation estimate of converting one value.
+
+  Complexities are kept as tuples of factors: () is free, ('1',) is constant.
+  """
+
+  def __init__(self, copy=(), allocs=(), note='', hints=()):
+    self.copy = tuple(copy)
+    self.allocs = tuple(allocs)
+    self.note = note
+    self.hints = list(hints)
+
+  def __str__(self):
+    return 'copy %s, allocs %s%s' % (
+        _BigO(self.copy), _BigO(self.allocs),
+        ', ' + self.note if self.note else '')
+
+
+def _BigO(factors):
+  if not factors:
+    return '0'
+  return 'O(%s)' % '*'.join(factors)
+
+
+def _Weight(factors):
+  return (len([f for f in factors if f != '1']), len(factors))
+
+
+def _PerElement(size, factors):
+  """Complexity of doing |factors| work for each of |size| elements."""
+  if not factors:
+    return ()
+  return (size,) + tuple(f for f in factors if f != '1')
+
+
+def TypeCost(t, direction, protos=(), enums=(), depth=0, cpp_exact_type='',
+             setter=False):
+  """Estimate the cost of converting AST.Type t in the given direction.
+
+  Args:
+    t: AST.Type proto (matched, cpp_type is set)
+    direction: _TO_CPP for arguments, _TO_PY for return values
+    protos: set of bare C++ proto message names
+    enums: set of bare C++ enum names wrapped in this module
+    depth: container nesting level (internal)
+    cpp_exact_type: AST.ParamDecl.cpp_exact_type of an argument
+    setter: t is assigned to a C++ member (property setter)
+
+  Returns:
+    Cost
+  """
+  cpp = _BareType(t.cpp_type)
+  to_py = direction == _TO_PY
+  if t.HasField('callable'):
+    if to_py:
+      return Cost(allocs=['1'], note='wraps std::function in a PyCFunction')
+    return Cost(allocs=['1'], note=(
+        'wraps a Python callable, each C++ call acquires the GIL'))
+  if cpp in protos or cpp.endswith('proto2::Message'):
+    return Cost(['size'], ['1'], note='proto serialized and parsed', hints=[
+        'proto %s crosses the language boundary by serialization, pass'
+        ' fewer or smaller messages on hot paths' % t.lang_type])
+  if t.params:
+    inner = [TypeCost(p, direction, protos, enums, depth+1) for p in t.params]
+    copy = max((c.copy for c in inner), key=_Weight)
+    allocs = max((c.allocs for c in inner), key=_Weight)
+    hints = [h for c in inner for h in c.hints]
+    if t.lang_type.startswith(('tuple<', 'NoneOr<')):
+      # Fixed size aggregates only add the cost of their elements.
+      return Cost(copy, allocs or (['1'] if to_py else []), hints=hints)
+    if not depth and not t.cpp_toptr_conversion:
+      if to_py:
+        hints.append('%s is copied element-wise into a new Python %s' % (
+            t.cpp_type, t.lang_type.partition('<')[0]))
+      else:
+        hints.append('%s is built element-wise from the Python object on every'
+                     ' call, wrap the container type to pass it by reference'
+                     % t.cpp_type)
+    size = _CONTAINER_SIZES[min(depth, len(_CONTAINER_SIZES)-1)]
+    return Cost(_PerElement(size, copy or ('1',)),
+                _PerElement(size, allocs) or ('1',),
+                note='element-wise copy', hints=hints)
+  if (t.lang_type in ('str', 'bytes') or
+      cpp in _STRING_TYPES or cpp.startswith('std::basic_string<')):
+    return Cost(['len'], ['1'])
+  if cpp in enums:
+    return Cost(['1'], note='Python Enum call') if to_py else Cost(['1'])
+  if t.cpp_raw_pointer or cpp.startswith(_SMART_PTRS):
+    return Cost(['1'], ['1'] if to_py else [])
+  if t.cpp_toptr_conversion or t.cpp_touniqptr_conversion:
+    # Wrapped class (or custom container) passed by value or reference.
+    if not to_py:
+      if setter:
+        return Cost(['sizeof'], note='copied into the C++ member')
+      if cpp_exact_type and not cpp_exact_type.rstrip().endswith(('&', '*')):
+        return Cost(['sizeof'], note='copied into the by-value parameter',
+                    hints=['%s is copied on every call, take it by const'
+                           ' reference instead' % cpp_exact_type])
+      return Cost(['1'], note='uses the wrapped C++ object in place')
+    if t.cpp_movable:
+      return Cost(['sizeof'], ['1'], note='moved into a new instance')
+    return Cost(['sizeof'], ['1'], note='copied into a new instance', hints=[
+        '%s is not movable and is copied, return std::unique_ptr<%s> to'
+        ' transfer ownership instead' % (t.cpp_type, cpp)])
+  return Cost(['1'], ['1'] if to_py else [])
+
+
+class _Reporter(object):
+  """Walk the AST and yield report lines."""
+
+  def __init__(self, protos, enums):
+    self.protos = protos
+    self.enums = enums
+
+  def _Line(self, what, t, direction, c=None):
+    c = c or TypeCost(t, direction, self.protos, self.enums)
+    yield '  %s: %s %s %s  %s' % (what, t.lang_type, direction, t.cpp_type, c)
+    for h in c.hints:
+      yield '  HINT: ' + h
+
+  def Func(self, qualname, f):
+    gil = 'holds GIL' if f.py_keep_gil else 'releases GIL'
+    kind = 'virtual def' if f.virtual else 'def'
+    yield '%s %s%s  [%s]' % (kind, qualname,
+                             next(astutils.Docstring(f))[len(f.name.native):],
+                             gil)
+    for p in f.params:
+      c = TypeCost(p.type, _TO_CPP, self.protos, self.enums,
+                   cpp_exact_type=p.cpp_exact_type)
+      for s in self._Line('arg ' + p.name.native, p.type, _TO_CPP, c):
+        yield s
+    for i, r in enumerate(f.returns):
+      what = 'return' if not i and not f.cpp_void_return else (
+          'output ' + (r.name.native or str(i)))
+      for s in self._Line(what, r.type, _TO_PY):
+        yield s
+    if f.virtual:
+      yield ('  NOTE: a Python override converts the arguments back to Python'
+             ' and reacquires the GIL on each C++ call')
+    yield ''
+
+  def Var(self, qualname, v):
+    yield 'property %s: %s  [holds GIL]' % (qualname, v.type.lang_type)
+    getter_cost = None
+    if (not v.cpp_get.name.cpp_name and v.type.cpp_toptr_conversion and
+        not v.type.cpp_raw_pointer and not v.type.cpp_abstract):
+      # pyext.WrapVar returns a view sharing ownership with self.
+      getter_cost = Cost(['1'], ['1'], note='shares the C++ member')
+    for s in self._Line('get', v.type, _TO_PY, getter_cost):
+      yield s
+    if v.cpp_get.name.cpp_name or v.cpp_get.name.native:
+      has_setter = v.cpp_set.name.cpp_name or v.cpp_set.name.native
+    else:
+      has_setter = True  # Plain data member.
+    if has_setter:
+      c = TypeCost(v.type, _TO_CPP, self.protos, self.enums, setter=True)
+      for s in self._Line('set', v.type, _TO_CPP, c):
+        yield s
+    yield ''
+
+  def Decls(self, decls, prefix=''):
+    for d in decls:
+      if d.decltype == d.FUNC:
+        for s in self.Func(prefix + d.func.name.native, d.func):
+          yield s
+      elif d.decltype == d.VAR:
+        for s in self.Var(prefix + d.var.name.native, d.var):
+          yield s
+      elif d.decltype == d.CLASS:
+        for s in self.Decls(d.class_.members,
+                            prefix + d.class_.name.native + '.'):
+          yield s
+
+
+def _Enums(decls):
+  for d in decls:
+    if d.decltype == d.ENUM:
+      yield _BareType(d.enum.name.cpp_name)
+    elif d.decltype == d.CLASS:
+      for e in _Enums(d.class_.members):
+        yield e
+
+
+def GenerateReport(ast, protos=()):
+  """Yield cost report lines for the matched AST proto."""
+  yield '# CLIF conversion cost report for %s' % ast.source
+  yield '# %s: argument conversion, %s: return value conversion.' % (
+      _TO_CPP, _TO_PY)
+  yield ''
+  reporter = _Reporter(set(protos), set(_Enums(ast.decls)))
+  for s in reporter.Decls(ast.decls):
+    yield s
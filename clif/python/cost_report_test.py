@@ -0,0 +1,163 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for clif.python.cost_report."""
+
+import textwrap
+import unittest
+
+from google.protobuf import text_format
+from clif.protos import ast_pb2
+from clif.python import cost_report
+
+
+class CostReportTest(unittest.TestCase):
+
+  def assertReportEqual(self, proto, report, protos=()):
+    ast = ast_pb2.AST()
+    text_format.Parse(proto, ast)
+    out = '\n'.join(cost_report.GenerateReport(ast, protos))+'\n'
+    self.assertMultiLineEqual(out, textwrap.dedent(report))
+
+  def testContainerOfStrings(self):
+    self.assertReportEqual("""
+      source: "m.clif"
+      decls {
+        decltype: FUNC
+        func {
+          name { native: "f" cpp_name: "f" }
+          params {
+            name { native: "d" }
+            type {
+              lang_type: "dict<int, str>"
+              cpp_type: "::std::map<int, ::std::string>"
+              params { lang_type: "int" cpp_type: "int" }
+              params { lang_type: "str" cpp_type: "::std::string" }
+            }
+            cpp_exact_type: "const ::std::map<int, ::std::string> &"
+          }
+          returns {
+            type {
+              lang_type: "list<str>"
+              cpp_type: "::std::vector<::std::string>"
+              params { lang_type: "str" cpp_type: "::std::string" }
+            }
+          }
+        }
+      }
+    """, """\
+      # CLIF conversion cost report for m.clif
+      # py->c++: argument conversion, c++->py: return value conversion.
+
+      def f(d:dict<int, str>) -> list<str>  [releases GIL]
+        arg d: dict<int, str> py->c++ ::std::map<int, ::std::string>  copy O(n*len), allocs O(n), element-wise copy
+        HINT: ::std::map<int, ::std::string> is built element-wise from the Python object on every call, wrap the container type to pass it by reference
+        return: list<str> c++->py ::std::vector<::std::string>  copy O(n*len), allocs O(n), element-wise copy
+        HINT: ::std::vector<::std::string> is copied element-wise into a new Python list
+
+    """)
+
+  def testClassMembers(self):
+    self.assertReportEqual("""
+      source: "m.clif"
+      decls {
+        decltype: CLASS
+        class_ {
+          name { native: "K" cpp_name: "K" }
+          members {
+            decltype: FUNC
+            func {
+              name { native: "Get" cpp_name: "Get" }
+              py_keep_gil: true
+              returns {
+                type {
+                  lang_type: "Msg"
+                  cpp_type: "::pkg::Msg"
+                }
+              }
+            }
+          }
+          members {
+            decltype: VAR
+            var {
+              name { native: "inner" cpp_name: "inner" }
+              type {
+                lang_type: "Inner"
+                cpp_type: "::Inner"
+                cpp_toptr_conversion: true
+              }
+            }
+          }
+        }
+      }
+    """, """\
+      # CLIF conversion cost report for m.clif
+      # py->c++: argument conversion, c++->py: return value conversion.
+
+      def K.Get() -> Msg  [holds GIL]
+        return: Msg c++->py ::pkg::Msg  copy O(size), allocs O(1), proto serialized and parsed
+        HINT: proto Msg crosses the language boundary by serialization, pass fewer or smaller messages on hot paths
+
+      property K.inner: Inner  [holds GIL]
+        get: Inner c++->py ::Inner  copy O(1), allocs O(1), shares the C++ member
+        set: Inner py->c++ ::Inner  copy O(sizeof), allocs 0, copied into the C++ member
+
+    """, protos={'pkg::Msg'})
+
+  def testNonMovableReturn(self):
+    t = ast_pb2.Type()
+    text_format.Parse("""
+      lang_type: "K"
+      cpp_type: "::K"
+      cpp_toptr_conversion: true
+      cpp_movable: false
+    """, t)
+    c = cost_report.TypeCost(t, cost_report._TO_PY)
+    self.assertEqual(str(c), 'copy O(sizeof), allocs O(1), copied into a new'
+                     ' instance')
+    self.assertEqual(len(c.hints), 1)
+
+  def testClassArguments(self):
+    self.assertReportEqual("""
+      source: "m.clif"
+      decls {
+        decltype: FUNC
+        func {
+          name { native: "f" cpp_name: "f" }
+          params {
+            name { native: "a" }
+            type { lang_type: "K" cpp_type: "::K" cpp_toptr_conversion: true }
+            cpp_exact_type: "const ::K &"
+          }
+          params {
+            name { native: "b" }
+            type { lang_type: "K" cpp_type: "::K" cpp_toptr_conversion: true }
+            cpp_exact_type: "::K"
+          }
+        }
+      }
+    """, """\
+      # CLIF conversion cost report for m.clif
+      # py->c++: argument conversion, c++->py: return value conversion.
+
+      def f(a:K, b:K)  [releases GIL]
+        arg a: K py->c++ ::K  copy O(1), allocs 0, uses the wrapped C++ object in place
+        arg b: K py->c++ ::K  copy O(sizeof), allocs 0, copied into the by-value parameter
+        HINT: ::K is copied on every call, take it by const reference instead
+
+    """)
+
+
+if __name__ == '__main__':
+  unittest.main()
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_FIELDS_H_
+#define CLIF_PYTHON_FIELDS_H_
+
+/*
+Conversions used by the getters and setters of the arithmetic data members of
+final classes (see pyext.WrapVar). They are inline and convert the common
+exact int, float and bool objects directly. Anything else goes through
+Clif_PyObjAs, so a field accepts the same values and reports the same errors
+as with the generic conversions.
+*/
+
+#include <Python.h>
+
+#include <limits>
+#include <type_traits>
+
+#include "clif/python/types.h"
+
+namespace clif {
+namespace field {
+
+template <typename T>
+inline PyObject* ToPy(const T& c) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return PyBool_FromLong(c);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return PyFloat_FromDouble(c);
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    if constexpr (sizeof(T) <= sizeof(long)) {  // NOLINT: runtime/int
+      return PyLong_FromLong(c);
+    } else {
+      return PyLong_FromLongLong(c);
+    }
+  } else if constexpr (std::is_integral_v<T>) {
+    if constexpr (sizeof(T) <= sizeof(long)) {  // NOLINT: runtime/int
+      return PyLong_FromUnsignedLong(c);
+    } else {
+      return PyLong_FromUnsignedLongLong(c);
+    }
+  } else {
+    return Clif_PyObjFrom(c, {});
+  }
+}
+
+template <typename T>
+inline bool FromPy(PyObject* py, T* c) {
+  if constexpr (std::is_same_v<T, bool>) {
+    if (py == Py_True || py == Py_False) {
+      *c = (py == Py_True);
+      return true;
+    }
+  } else if constexpr (std::is_floating_point_v<T>) {
+    if (PyFloat_CheckExact(py)) {
+      *c = static_cast<T>(PyFloat_AS_DOUBLE(py));
+      return true;
+    }
+  } else if constexpr (std::is_integral_v<T>) {
+    if (PyLong_CheckExact(py)) {
+      int overflow;
+      long long v = PyLong_AsLongLongAndOverflow(py, &overflow);  // NOLINT
+      bool in_range;
+      if constexpr (std::is_signed_v<T>) {
+        in_range = v >= std::numeric_limits<T>::min() &&
+                   v <= std::numeric_limits<T>::max();
+      } else {
+        in_range = v >= 0 && static_cast<unsigned long long>(v) <=  // NOLINT
+                                 std::numeric_limits<T>::max();
+      }
+      if (!overflow && in_range) {
+        *c = static_cast<T>(v);
+        return true;
+      }
+    }
+  }
+  // Out of range or another type: convert as usual to get the error right.
+  return Clif_PyObjAs(py, c);
+}
+
+}  // namespace field
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_FIELDS_H_
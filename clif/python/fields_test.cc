@@ -0,0 +1,116 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "clif/python/fields.h"
+
+#include <Python.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace clif {
+namespace field {
+namespace {
+
+class FieldsTest : public ::testing::Test {
+ protected:
+  FieldsTest() { Py_Initialize(); }
+
+  // Returns the result of FromPy(|expr|) and clears the Python error.
+  template <typename T>
+  bool Set(const char* expr, T* c) {
+    PyObject* globals = PyDict_New();
+    PyObject* py = PyRun_String(expr, Py_eval_input, globals, globals);
+    Py_DECREF(globals);
+    EXPECT_NE(py, nullptr) << expr;
+    bool ok = FromPy(py, c);
+    Py_DECREF(py);
+    if (!ok) {
+      EXPECT_TRUE(PyErr_Occurred());
+      PyErr_Clear();
+    }
+    return ok;
+  }
+
+  // Returns repr(ToPy(c)).
+  template <typename T>
+  std::string Repr(T c) {
+    PyObject* py = ToPy(c);
+    PyObject* repr = PyObject_Repr(py);
+    std::string s = PyUnicode_AsUTF8(repr);
+    Py_DECREF(repr);
+    Py_DECREF(py);
+    return s;
+  }
+};
+
+TEST_F(FieldsTest, ToPy) {
+  EXPECT_EQ(Repr(true), "True");
+  EXPECT_EQ(Repr(-7), "-7");
+  EXPECT_EQ(Repr(std::uint64_t{1} << 63), "9223372036854775808");
+  EXPECT_EQ(Repr(std::numeric_limits<std::int64_t>::min() / 2),
+            "-4611686018427387904");
+  EXPECT_EQ(Repr(0.5f), "0.5");
+}
+
+TEST_F(FieldsTest, Int) {
+  int i = 0;
+  EXPECT_TRUE(Set("-42", &i));
+  EXPECT_EQ(i, -42);
+  EXPECT_TRUE(Set("True", &i));  // bool is an int, as for Clif_PyObjAs.
+  EXPECT_EQ(i, 1);
+  EXPECT_FALSE(Set("2**40", &i));
+  EXPECT_FALSE(Set("1.5", &i));
+  EXPECT_EQ(i, 1);
+}
+
+TEST_F(FieldsTest, Unsigned) {
+  std::uint8_t b = 0;
+  EXPECT_TRUE(Set("255", &b));
+  EXPECT_EQ(b, 255);
+  EXPECT_FALSE(Set("256", &b));
+  EXPECT_FALSE(Set("-1", &b));
+  std::uint64_t u = 0;
+  EXPECT_TRUE(Set("2**64 - 1", &u));  // Past the fast path.
+  EXPECT_EQ(u, ~std::uint64_t{0});
+}
+
+TEST_F(FieldsTest, Float) {
+  double d = 0;
+  EXPECT_TRUE(Set("0.25", &d));
+  EXPECT_EQ(d, 0.25);
+  EXPECT_TRUE(Set("3", &d));
+  EXPECT_EQ(d, 3);
+  EXPECT_FALSE(Set("'3'", &d));
+  float f = 0;
+  EXPECT_TRUE(Set("1.5", &f));
+  EXPECT_EQ(f, 1.5f);
+}
+
+TEST_F(FieldsTest, Bool) {
+  bool b = false;
+  EXPECT_TRUE(Set("True", &b));
+  EXPECT_TRUE(b);
+  EXPECT_TRUE(Set("False", &b));
+  EXPECT_FALSE(b);
+  EXPECT_FALSE(Set("1", &b));
+}
+
+}  // namespace
+}  // namespace field
+}  // namespace clif
@@ -79,6 +79,48 @@ class FuncTest(unittest.TestCase):
       }
     """)
 
+  def testIntFunc0Probes(self):
+    self.m.probes = True
+    self.assertFuncEqual("""
+      name {
+        native: "f"
+        cpp_name: "ns::f"
+      }
+      returns {
+        type {
+          lang_type: "int"
+          cpp_type: "int32"
+        }
+      }
+    """, """
+      // f() -> int
+      PyObject* wrapf(PyObject* self)
+          CLIF_WRAPPER_SYMBOL("my.test.f");
+      PyObject* wrapf(PyObject* self) {
+        ::clif::probes::CallScope clif_probe("my.test.f: int32 ns::f()");
+        // Call actual C++ method.
+        PyThreadState* _save;
+        Py_UNBLOCK_THREADS
+        clif_probe.GilReleased();
+        int32 ret0 = ns::f();
+        Py_BLOCK_THREADS
+        clif_probe.GilAcquired();
+        return Clif_PyObjFrom(std::move(ret0), {});
+      }
+    """)
+
+  def testProbesWrapperSymbolsUnique(self):
+    self.m.probes = True
+    symbols = []
+    for _ in range(2):
+      ast = ast_pb2.FuncDecl()
+      text_format.Parse('name { native: "f" cpp_name: "f" }', ast)
+      out = '\n'.join(self.m.WrapFunc(ast, -1, ''))
+      symbols.extend(l.strip() for l in out.splitlines()
+                     if 'CLIF_WRAPPER_SYMBOL' in l)
+    self.assertEqual(symbols, ['CLIF_WRAPPER_SYMBOL("my.test.f");',
+                               'CLIF_WRAPPER_SYMBOL("my.test.f_");'])
+
   def testIntFunc0Post(self):
     self.assertFuncEqual("""
       py_keep_gil: true
@@ -194,14 +194,25 @@ class _GetSetDef(object):
 GetSetDef = _GetSetDef()  # pylint: disable=invalid-name
 
 
-def _TypesInitInDependencyOrder(types_init, raise_if_reordering=False):
-  """Yields type_init items in dependency order: base classes before derived."""
+def _TypesInitInDependencyOrder(types_init, raise_if_reordering=False,
+                                prebuilt=()):
+  """Yields type_init items in dependency order: base classes before derived.
+
+  Args:
+    types_init: [(cppname, base, wrapped_base, dict)]
+    raise_if_reordering: for development / debugging
+    prebuilt: cppnames of wrapped bases built before types_init
+  Yields:
+    types_init items
+  """
   cppname_indices = {}
   for index, (cppname, _, _, _) in enumerate(types_init):
     cppname_indices[cppname] = index
   assert len(cppname_indices) == len(types_init)
   ideps = []
   for cppname, _, wrapped_base, _ in types_init:
+    if wrapped_base in prebuilt:
+      wrapped_base = None
     if wrapped_base is not None and wrapped_base not in cppname_indices:
       # INDIRECT DETECTION. Considering current development plans, this code
       # generator is not worth more effort detecting the issue in a more direct
@@ -227,15 +238,53 @@ def _TypesInitInDependencyOrder(types_init, raise_if_reordering=False):
     yield types_init[index]
 
 
-def ReadyFunction(types_init):
+def ReadyFunction(types_init, import_time=False):
   """Generate Ready() function to call PyType_Ready for wrapped types."""
   yield ''
   yield 'bool Ready() {'
+  if import_time:
+    yield I+'::clif::ImportTimer import_time(ThisModuleName, "Ready()");'
+  for s in _ReadyTypes(types_init, import_time=import_time):
+    yield s
+  yield I+'return true;'
+  yield '}'
+
+
+def ImportTimeStep(name):
+  """Generate the start of an import step timed by ::clif::ImportTimer."""
+  return 'import_time.Step("%s");' % name
+
+
+def PyNameOfType(cppname):
+  """Python name (Outer.Inner) of a pyOuter::pyInner::wrapper_Type."""
+  return '.'.join(ns[2:] for ns in cppname.split('::')[:-1])
+
+
+def _ReadyTypes(types_init, prebuilt=(), import_time=False, lazy=False):
+  """Generate statements building types_init types, return false on error.
+
+  Args:
+    types_init: [(cppname, base, wrapped_base, _)] types to build
+    prebuilt: cppnames of the types built by other units
+    import_time: time the steps of building each class (see ImportTimer)
+    lazy: build each type in a local and set its cppname only after
+      PyType_Ready succeeds (see LazyTypes)
+  Yields:
+    Source code statements.
+  """
   have_modname = False
   pybases = set()
   last_pybase = ''
-  for cppname, base, wrapped_base, _ in _TypesInitInDependencyOrder(types_init):
-    yield I+'%s =' % cppname
+  for index, (cppname, base, wrapped_base, _) in enumerate(
+      _TypesInitInDependencyOrder(types_init, prebuilt=prebuilt)):
+    if import_time:
+      yield I+ImportTimeStep('class %s' % PyNameOfType(cppname))
+    if lazy:
+      ty = 'type%d' % index
+      yield I+'PyTypeObject* %s =' % ty
+    else:
+      ty = cppname
+      yield I+'%s =' % cppname
     yield I+'%s::_build_heap_type();' % cppname.rsplit('::', 1)[0]
     if base:
       fq_name, toplevel_fq_name = base
@@ -245,6 +294,8 @@ def ReadyFunction(types_init):
         yield I+'Py_INCREF(base_cls);'
       else:
         type_prefix = '' if pybases else 'PyObject* '
+        if import_time:
+          yield I+ImportTimeStep('import base %s' % fq_name)
         if toplevel_fq_name:
           yield I+('%sbase_cls = ImportFQName("%s", "%s");' %
                    (type_prefix, fq_name, toplevel_fq_name))
@@ -260,10 +311,10 @@ def ReadyFunction(types_init):
             'new style class inheriting from object.");' % fq_name)
         yield I+I+'return false;'
         yield I+'}'
-      yield I+cppname + '->tp_base = %s(base_cls);' % _Cast('PyTypeObject')
+      yield I+ty + '->tp_base = %s(base_cls);' % _Cast('PyTypeObject')
       if base not in pybases:
         yield I+'// Check that base_cls is a *statically* allocated PyType.'
-        yield I+'if (%s->tp_base->tp_alloc == PyType_GenericAlloc) {' % cppname
+        yield I+'if (%s->tp_base->tp_alloc == PyType_GenericAlloc) {' % ty
         yield I+I+'Py_DECREF(base_cls);'
         yield I+I+('PyErr_SetString(PyExc_TypeError, "Base class %s is a'
                    ' dynamic (Python defined) class.");' % fq_name)
@@ -274,21 +325,146 @@ def ReadyFunction(types_init):
     elif wrapped_base:
       # base is Python wrapper type in a C++ class namespace defined locally.
       yield I+'Py_INCREF(%s);' % wrapped_base
-      yield I+'%s->tp_base = %s;' % (cppname, wrapped_base)
+      yield I+'%s->tp_base = %s;' % (ty, wrapped_base)
 
-    yield I+'if (PyType_Ready(%s) < 0) return false;' % cppname
+    yield I+'if (PyType_Ready(%s) < 0) return false;' % ty
     if not have_modname:
       yield I+'PyObject *modname = PyUnicode_FromString(ThisModuleName);'
       yield I+'if (modname == nullptr) return false;'
       have_modname = True
     yield I+('PyObject_SetAttrString((PyObject *) %s, "__module__", modname);'
-             % cppname)
-    yield I+'Py_INCREF(%s);  // For PyModule_AddObject to steal.' % cppname
-  yield I+'return true;'
+             % ty)
+    yield I+'Py_INCREF(%s);  // For PyModule_AddObject to steal.' % ty
+    if lazy:
+      yield I+'%s = %s;' % (cppname, ty)
+
+
+def LazyTypes(units, lazy_names, prebuilt, import_time=False):
+  """Generate types built on first use (pyclif --lazy_types).
+
+  Each top-level class namespace gets a ReadyType() function that builds the
+  class, its nested classes and the classes it derives from. It is called
+  by ThisPtr(), Clif_PyObjFrom() and the module __getattr__ (PEP 562), which
+  also creates top-level enums (see EnumType.CreateEnum).
+
+  Args:
+    units: [(ns, types_init, base_ns, dict_)] - top-level class namespace,
+      its types_init entries, namespaces of the top-level classes it derives
+      from and its [(type, name, value, can_fail)] tp_dict entries.
+    lazy_names: [(pyname, getter)] - module attributes created on first
+      access by getter() returning a borrowed reference.
+    prebuilt: cppnames of the types built by other units
+    import_time: time the steps of building each class (see ImportTimer)
+  Yields:
+    ReadyType(), LazyGetAttr() and LazyDir() functions source
+  """
+  for ns, types_init, base_ns, dict_ in units:
+    yield ''
+    yield 'namespace %s {' % ns
+    yield ''
+    yield 'static bool BuildTypes() {'
+    if import_time:
+      yield I+('::clif::ImportTimer import_time(ThisModuleName,'
+               ' "lazy class %s");' % ns[2:])
+    for s in _ReadyTypes(types_init, prebuilt, import_time, lazy=True):
+      yield s
+    for cppname, n, o, can_fail in dict_:
+      if can_fail:
+        yield I+'if (%s == nullptr) return false;' % o
+      yield I+('if (PyDict_SetItemString(%s->tp_dict, "%s", %s) < 0)'
+               ' return false;' % (cppname, n, o))
+    yield I+'return true;'
+    yield '}'
+    yield ''
+    yield 'static bool ReadyType() {'
+    yield I+'static bool ready = false;'
+    yield I+'static unsigned long builder = 0;  // Thread ident, 0 if none.'
+    yield I+'static PyThread_type_lock building = PyThread_allocate_lock();'
+    yield I+'// Building runs Python code (imports of bases), which may use it'
+    yield I+'// in this thread or release the GIL to other threads.'
+    yield I+'while (!ready && builder != 0) {'
+    yield I+I+'if (builder == PyThread_get_thread_ident()) {'
+    yield I+I+I+('PyErr_SetString(PyExc_ImportError, "class %s is used while'
+                 ' it is being built");' % ns[2:])
+    yield I+I+I+'return false;'
+    yield I+I+'}'
+    yield I+I+'// Wait for the other thread to finish, without the GIL.'
+    yield I+I+'Py_BEGIN_ALLOW_THREADS'
+    yield I+I+'PyThread_acquire_lock(building, WAIT_LOCK);'
+    yield I+I+'PyThread_release_lock(building);'
+    yield I+I+'Py_END_ALLOW_THREADS'
+    yield I+'}'
+    yield I+'if (ready) return true;'
+    yield I+'if (building == nullptr) {'
+    yield I+I+'PyErr_NoMemory();'
+    yield I+I+'return false;'
+    yield I+'}'
+    yield I+'builder = PyThread_get_thread_ident();'
+    yield I+'PyThread_acquire_lock(building, WAIT_LOCK);'
+    yield I+'bool ok = %s;' % ' && '.join(
+        ['%s::ReadyType()' % b for b in base_ns] + ['BuildTypes()'])
+    yield I+'PyThread_release_lock(building);'
+    yield I+'builder = 0;'
+    yield I+'if (!ok) {'
+    for cppname, _, _, _ in types_init:
+      yield I+I+'%s = nullptr;' % cppname
+    yield I+I+'return false;'
+    yield I+'}'
+    yield I+'ready = true;'
+    yield I+'return true;'
+    yield '}'
+    yield ''
+    yield 'static PyObject* GetType() {'
+    yield I+'if (!ReadyType()) return nullptr;'
+    yield I+'return reinterpret_cast<PyObject*>(wrapper_Type);'
+    yield '}'
+    yield ''
+    yield '}  // namespace %s' % ns
+  yield ''
+  yield 'static const struct {'
+  yield I+'const char* name;'
+  yield I+'PyObject* (*get)();  // Borrowed reference.'
+  yield '} kLazyTypes[] = {'
+  for pyname, getter in lazy_names:
+    yield I+'{"%s", %s},' % (pyname, getter)
+  yield '};'
+  yield ''
+  yield 'static PyObject* LazyGetAttr(PyObject* module, PyObject* name) {'
+  yield I+'const char* n = PyUnicode_AsUTF8(name);'
+  yield I+'if (n == nullptr) return nullptr;'
+  yield I+'for (const auto& t : kLazyTypes) {'
+  yield I+I+'if (strcmp(n, t.name) != 0) continue;'
+  yield I+I+'PyObject* obj = t.get();'
+  yield I+I+'if (obj == nullptr) return nullptr;'
+  yield I+I+'// Next lookups find it in the module dict.'
+  yield I+I+'if (PyObject_SetAttr(module, name, obj) < 0) return nullptr;'
+  yield I+I+'Py_INCREF(obj);'
+  yield I+I+'return obj;'
+  yield I+'}'
+  yield I+('PyErr_Format(PyExc_AttributeError,'
+           ' "module \'%s\' has no attribute \'%s\'", ThisModuleName, n);')
+  yield I+'return nullptr;'
+  yield '}'
+  yield ''
+  yield 'static PyObject* LazyDir(PyObject* module, PyObject*) {'
+  yield I+'PyObject* dict = PyModule_GetDict(module);'
+  yield I+'PyObject* names = PyDict_Keys(dict);'
+  yield I+'if (names == nullptr) return nullptr;'
+  yield I+'for (const auto& t : kLazyTypes) {'
+  yield I+I+'if (PyDict_GetItemString(dict, t.name) != nullptr) continue;'
+  yield I+I+'PyObject* name = PyUnicode_FromString(t.name);'
+  yield I+I+'if (name == nullptr || PyList_Append(names, name) < 0) {'
+  yield I+I+I+'Py_XDECREF(name);'
+  yield I+I+I+'Py_DECREF(names);'
+  yield I+I+I+'return nullptr;'
+  yield I+I+'}'
+  yield I+I+'Py_DECREF(name);'
+  yield I+'}'
+  yield I+'return names;'
   yield '}'
 
 
-def InitFunction(doc, meth_ref, init, dict_):
+def InitFunction(doc, meth_ref, init, dict_, import_time=False):
   """Generate a function to create the module and initialize it."""
   yield ''
   yield 'static struct PyModuleDef Module = {'
@@ -303,6 +479,9 @@ def InitFunction(doc, meth_ref, init, dict_):
   yield '};'
   yield ''
   yield 'PyObject* Init() {'
+  if import_time:
+    yield I+'::clif::ImportTimer import_time(ThisModuleName, "Init()");'
+    yield I+ImportTimeStep('PyModule_Create')
   yield I+'PyObject* module = PyModule_Create(&Module);'
   yield I+'if (!module) return nullptr;'
   init_needs_err = False
@@ -311,6 +490,8 @@ def InitFunction(doc, meth_ref, init, dict_):
     if ' err;' in s: init_needs_err = True
     yield I+s
   for pair in dict_:
+    if import_time:
+      yield I+ImportTimeStep(pair[0])
     yield I+'if (PyModule_AddObject(module, "%s", %s) < 0) goto err;' % pair
   yield I+'return module;'
   if init_needs_err or dict_:
@@ -320,6 +501,66 @@ def InitFunction(doc, meth_ref, init, dict_):
   yield '}'
 
 
+def CApiStruct(capsule_name, entries):
+  """Generate the C-API table declaration (see clif/python/capi.h).
+
+  Args:
+    capsule_name: str - full.module.name._C_API
+    entries: [(name, return type, (params), value)]
+
+  Yields:
+    CApi struct source
+  """
+  decls = ['%s (*%s)%s' % (r, n, p) for n, r, p, _ in entries]
+  yield ''
+  yield '// Table of C++ entry points exported in the %s PyCapsule.' % (
+      capsule_name)
+  yield 'struct CApi {'
+  yield I+'::clif::capi::TableHeader header;'
+  for d in decls:
+    yield I+d+';'
+  yield ''
+  yield I+'static constexpr const char* kCapsuleName = "%s";' % capsule_name
+  yield I+'static constexpr const char* kLayout ='
+  for d in decls:
+    yield I+I+'"%s;"' % d
+  yield I+I+'"";'
+  yield I+'static const CApi* Import() {'
+  yield I+I+'return ::clif::capi::Import<CApi>();'
+  yield I+'}'
+  yield '};'
+
+
+def CApiThisPtr(classes):
+  """Generate capi::<Class>_ThisPtr() helpers for [(capi_name, cpp_name)]."""
+  yield ''
+  yield '// C++ pointer from a wrapped object or nullptr with Python error set.'
+  yield 'namespace capi {'
+  for name, cname in classes:
+    yield ''
+    yield 'inline %s* %s_ThisPtr(PyObject* py) {' % (cname, name)
+    yield I+'const CApi* api = ::clif::capi::Get<CApi>();'
+    yield I+'return api ? api->%s_ThisPtr(py) : nullptr;' % name
+    yield '}'
+  yield ''
+  yield '}  // namespace capi'
+
+
+def CApiCapsule(entries):
+  """Generate the C-API table definition and CApiCapsule() to export it."""
+  yield ''
+  yield 'static const CApi c_api = {'
+  yield I+'{::clif::capi::kVersion, CApi::kLayout},'
+  for _, _, _, value in entries:
+    yield I+value+','
+  yield '};'
+  yield ''
+  yield 'PyObject* CApiCapsule() {'
+  yield I+('return PyCapsule_New(const_cast<CApi*>(&c_api), CApi::kCapsuleName,'
+           ' nullptr);')
+  yield '}'
+
+
 def PyModInitFunction(init_name='', modname='', ns=''):
   """Generate extension module init function."""
   assert (init_name or modname) and not (init_name and modname)  # xor
@@ -403,8 +644,13 @@ def TypeObject(ht_qualname, tracked_slot_groups,
     yield ''
     yield '// %s __new__' % pyname
     yield 'static PyObject* _new(PyTypeObject* type, Py_ssize_t nitems);'
+    yield ('static PyObject* _tp_new(PyTypeObject* type, PyObject* args, '
+           'PyObject* kw);')
     tp_slots['tp_alloc'] = '_new'
-    tp_slots['tp_new'] = 'PyType_GenericNew'
+    tp_slots['tp_new'] = '_tp_new'
+    yield ''
+    yield ('static ::clif::InstanceCounter instance_counter{"%s", sizeof(%s)};'
+           % (fqclassname, fqclassname))
   yield ''
   yield '// %s __del__' % pyname
   # Use dtor for dynamic types (derived) to wind down malloc'ed C++ obj, so
@@ -412,6 +658,7 @@ def TypeObject(ht_qualname, tracked_slot_groups,
   tp_slots['tp_dealloc'] = '_dtor'
   yield 'static void _dtor(PyObject* self) {'
   if not iterator:
+    yield I+'instance_counter.Destroyed();'
     yield I+'if (%s(self)->weakrefs) {' % _Cast(wname)
     yield I+I+'PyObject_ClearWeakRefs(self);'
     yield I+'}'
@@ -463,6 +710,8 @@ def TypeObject(ht_qualname, tracked_slot_groups,
   yield I+'ty->tp_as_number = &heap_type->as_number;'
   yield I+'ty->tp_as_sequence = &heap_type->as_sequence;'
   yield I+'ty->tp_as_mapping = &heap_type->as_mapping;'
+  if 'bf' in tracked_slot_groups:
+    yield I+'ty->tp_as_buffer = &heap_type->as_buffer;'
   yield '#if PY_VERSION_HEX >= 0x03050000'
   yield I+'ty->tp_as_async = &heap_type->as_async;'
   yield '#endif'
@@ -473,6 +722,7 @@ def TypeObject(ht_qualname, tracked_slot_groups,
       yield (I+'pyclif_instance_dict_enable(ty, offsetof(%s, instance_dict));'
              % wname)
     yield I+'ty->tp_weaklistoffset = offsetof(wrapper, weakrefs);'
+    yield I+'::clif::RegisterInstanceCounter(ty->tp_name, &instance_counter);'
   yield I+'return ty;'
   yield '}'
   if ctor:
@@ -531,8 +781,17 @@ def TypeObject(ht_qualname, tracked_slot_groups,
     if enable_instance_dict:
       yield I+'wobj->instance_dict = nullptr;'
     yield I+'PyObject* self = %s(wobj);' % _Cast()
+    yield I+'instance_counter.Created();'
     yield I+'return PyObject_Init(self, %s);' % wtype
     yield '}'
+    yield ''
+    # Python subclasses are allocated by Python, not _new.
+    yield ('static PyObject* _tp_new(PyTypeObject* type, PyObject* args, '
+           'PyObject* kw) {')
+    yield I+'PyObject* self = PyType_GenericNew(type, args, kw);'
+    yield I+'if (self && type->tp_alloc != _new) instance_counter.Created();'
+    yield I+'return self;'
+    yield '}'
 
 
 def _CreateInputParameter(func_name, ast_param, arg, args):
@@ -601,7 +860,8 @@ def _CreateInputParameter(func_name, ast_param, arg, args):
 
 
 def FunctionCall(pyname, wrapper, doc, catch, call, postcall_init,
-                 typepostconversion, func_ast, lineno, prepend_self=None):
+                 typepostconversion, func_ast, lineno, prepend_self=None,
+                 probe=None, symbol=None):
   """Generate PyCFunction wrapper from AST.FuncDecl func_ast.
 
   Args:
@@ -616,6 +876,9 @@ def FunctionCall(pyname, wrapper, doc, catch, call, postcall_init,
     func_ast: AST.FuncDecl protobuf
     lineno: int - .clif line number where func_ast defined
     prepend_self: AST.Param - Use self as 1st parameter.
+    probe: str - name for the USDT probes (see probes.h), None for no probes.
+    symbol: str - exported symbol name of the wrapper (see probes.h), None to
+      keep it static.
 
   Yields:
      Source code for wrapped function.
@@ -646,8 +909,17 @@ def FunctionCall(pyname, wrapper, doc, catch, call, postcall_init,
     yield '// ' + doc
     arg0 = 'self'
   needs_kw = nargs or is_ternaryfunc_slot
-  yield 'static PyObject* %s(PyObject* %s%s) {' % (
+  signature = 'PyObject* %s(PyObject* %s%s)' % (
       wrapper, arg0, ', PyObject* args, PyObject* kw' if needs_kw else '')
+  if symbol:
+    # An asm label is only allowed on a declaration, not on the definition.
+    yield signature
+    yield I+I+'CLIF_WRAPPER_SYMBOL("%s");' % symbol
+    yield signature + ' {'
+  else:
+    yield 'static %s {' % signature
+  if probe:
+    yield I+'::clif::probes::CallScope clif_probe("%s");' % probe
   if is_ternaryfunc_slot and not nargs:
     yield I+('if (!ensure_no_args_and_kw_args("%s", args, kw)) return nullptr;'
              % pyname)
@@ -755,6 +1027,8 @@ def FunctionCall(pyname, wrapper, doc, catch, call, postcall_init,
       yield I+'Py_XINCREF(kw);'
     yield I+'PyThreadState* _save;'
     yield I+'Py_UNBLOCK_THREADS'
+    if probe:
+      yield I+'clif_probe.GilReleased();'
   optional_ret0 = False
   convert_ref_to_ptr = False
   if (minargs < nargs or catch) and not void_return_type:
@@ -815,6 +1089,8 @@ def FunctionCall(pyname, wrapper, doc, catch, call, postcall_init,
       yield I+'ret0'+postcall_init
   if not func_ast.py_keep_gil:
     yield I+'Py_BLOCK_THREADS'
+    if probe:
+      yield I+'clif_probe.GilAcquired();'
     if nargs:
       yield I+'Py_DECREF(args);'
       yield I+'Py_XDECREF(kw);'
@@ -945,6 +1221,85 @@ def CastAsCapsule(wrapped_cpp, pointer_name, wrapper):
   yield '}'
 
 
+def ClifSharedPtr(wrapped_cpp, cname, virtual, wrapper):
+  """Generate the __clif_shared_ptr__ method (see clif/python/interop.h)."""
+  yield ''
+  yield '// Share this C++ object with wrappers of other CLIF backends.'
+  yield 'static PyObject* %s(PyObject* self) {' % wrapper
+  yield I+'%s* p = ::clif::python::Get(%s);' % (cname, wrapped_cpp)
+  yield I+'if (p == nullptr) return nullptr;'
+  if virtual:
+    shared = '::clif::MakeSharedVirtual<%s>(%s, self)' % (cname, wrapped_cpp)
+  else:
+    shared = '::clif::MakeStdShared(%s, p)' % wrapped_cpp
+  yield I+'return ::clif::interop::SharedPtrCapsule(%s);' % shared
+  yield '}'
+
+
+def SizeOf(wrapped_cpp, wrapper):
+  """Generate the __sizeof__ method (see clif::SizeOf)."""
+  yield ''
+  yield 'static PyObject* %s(PyObject* self) {' % wrapper
+  yield I+'return ::clif::SizeOf(self, %s);' % wrapped_cpp
+  yield '}'
+
+
+def CppHash(cname, hasher):
+  """Generate tp_hash calling the C++ hasher of the class."""
+  yield ''
+  yield 'static Py_hash_t cpp_hash(PyObject* self) {'
+  yield I+'%s* c = ThisPtr(self);' % cname
+  yield I+'if (c == nullptr) return -1;'
+  yield I+'return ::clif::slot::hash_value(%s<%s>()(*c));' % (hasher, cname)
+  yield '}'
+CppHash.name = 'cpp_hash'  # Generated C++ name.
+
+
+def CppRichCompare(cname, wrapper_type, ordered):
+  """Generate tp_richcompare calling C++ operator== [and operator<]."""
+  yield ''
+  yield 'extern PyTypeObject* %s;' % wrapper_type
+  yield 'static PyObject* cpp_richcmp(PyObject* self, PyObject* other, int op) {'
+  yield I+'if (!PyObject_TypeCheck(other, %s)) Py_RETURN_NOTIMPLEMENTED;' % (
+      wrapper_type)
+  yield I+'%s* a = ThisPtr(self);' % cname
+  yield I+'if (a == nullptr) return nullptr;'
+  yield I+'%s* b = ThisPtr(other);' % cname
+  yield I+'if (b == nullptr) return nullptr;'
+  yield I+'bool r;'
+  yield I+'switch (op) {'
+  yield I+I+'case Py_EQ: r = *a == *b; break;'
+  yield I+I+'case Py_NE: r = !(*a == *b); break;'
+  if ordered:
+    yield I+I+'case Py_LT: r = *a < *b; break;'
+    yield I+I+'case Py_GT: r = *b < *a; break;'
+    yield I+I+'case Py_LE: r = !(*b < *a); break;'
+    yield I+I+'case Py_GE: r = !(*a < *b); break;'
+  yield I+I+'default: Py_RETURN_NOTIMPLEMENTED;'
+  yield I+'}'
+  yield I+'return PyBool_FromLong(r);'
+  yield '}'
+CppRichCompare.name = 'cpp_richcmp'  # Generated C++ name.
+
+
+def BufferProcs(cname, wrapped_cpp, buf):
+  """Generate bf_getbuffer exporting the C++ storage (see buffer.h)."""
+  shape = 'c->%s()' % (buf.shape or 'size')
+  strides = ('c->%s()' % buf.strides if buf.strides else
+             '::clif::buffer::CContiguous()')
+  fmt = ('c->%s()' % buf.format if buf.format else
+         '::clif::buffer::ElementFormat()')
+  yield ''
+  yield 'static int buffer_get(PyObject* self, Py_buffer* view, int flags) {'
+  yield I+'%s* c = ThisPtr(self);' % cname
+  yield I+'if (c == nullptr) return -1;'
+  yield I+'return ::clif::buffer::Export(self, view, flags,'
+  yield I+I+'::clif::MakeStdShared(%s), c->%s(),' % (wrapped_cpp, buf.data)
+  yield I+I+'%s, %s, %s);' % (shape, strides, fmt)
+  yield '}'
+BufferProcs.name = 'buffer_get'  # Generated C++ name.
+
+
 class _NewIter(object):
   """Generate the new_iter function."""
   name = 'new_iter'
@@ -1000,7 +1355,8 @@ def VarGetter(name, cfunc, error, cvar, pc, is_extend=False):
   yield '}'
 
 
-def VarSetter(name, cfunc, error, cvar, v, csetter, as_str, is_extend=False):
+def VarSetter(name, cfunc, error, cvar, v, csetter, as_str, is_extend=False,
+              view=False):
   """Generate var setter.
 
   Args:
@@ -1012,6 +1368,7 @@ def VarSetter(name, cfunc, error, cvar, v, csetter, as_str, is_extend=False):
     csetter: C++ call expression to set var (without '(newvalue)') if any
     as_str: Python str -> C str function (different for Py2/3)
     is_extend: True for @extend properties in the .clif file.
+    view: True for @view vars, to copy from a view without clearing cvar.
 
   Yields:
      Source code for setter function.
@@ -1046,6 +1403,8 @@ def VarSetter(name, cfunc, error, cvar, v, csetter, as_str, is_extend=False):
   if not csetter:
     if error:
       yield I+error+ret_error
+    if view:
+      yield I+'if (::clif::view::Assign(value, &%s)) ' % cvar + ret_ok
     yield I+'if (Clif_PyObjAs(value, &%s)) ' % cvar + ret_ok
   yield I+'PyObject* s = PyObject_Repr(value);'
   yield I+('PyErr_Format(PyExc_ValueError, "%s is not valid for {}:{}", s? {}'
@@ -1055,6 +1414,36 @@ def VarSetter(name, cfunc, error, cvar, v, csetter, as_str, is_extend=False):
   yield '}'
 
 
+def FieldGetter(name, wrapped_cpp, field):
+  """Generate the getter of an arithmetic data member of a final class."""
+  yield ''
+  yield 'static PyObject* %s(PyObject* self, void* xdata) {' % name
+  yield I+'auto* c = ::clif::python::Get(%s);' % wrapped_cpp
+  yield I+'if (c == nullptr) return nullptr;'
+  yield I+'return ::clif::field::ToPy(c->%s);' % field
+  yield '}'
+
+
+def FieldSetter(name, wrapped_cpp, field, v, as_str):
+  """Generate the setter of an arithmetic data member of a final class."""
+  yield ''
+  yield 'static int %s(PyObject* self, PyObject* value, void* xdata) {' % name
+  yield I+'if (value == nullptr) {'
+  yield I+I+('PyErr_SetString(PyExc_TypeError, "Cannot delete the'
+             ' %s attribute");' % v.name.native)
+  yield I+I+'return -1;'
+  yield I+'}'
+  yield I+'auto* c = ::clif::python::Get(%s);' % wrapped_cpp
+  yield I+'if (c == nullptr) return -1;'
+  yield I+'if (::clif::field::FromPy(value, &c->%s)) return 0;' % field
+  yield I+'PyObject* s = PyObject_Repr(value);'
+  yield I+('PyErr_Format(PyExc_ValueError, "%s is not valid for {}:{}", s? {}'
+           '(s): "input");').format(v.name.native, v.type.lang_type, as_str)
+  yield I+'Py_XDECREF(s);'
+  yield I+'return -1;'
+  yield '}'
+
+
 def _Cast(t='PyObject'):
   assert not t.endswith('*')
   return 'reinterpret_cast<%s*>' % t
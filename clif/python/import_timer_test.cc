@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Python.h>
+
+#include <chrono>  // NOLINT: build/c++11
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>  // NOLINT: build/c++11
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "clif/python/runtime.h"
+
+namespace clif {
+namespace {
+
+// A parsed "import time: self | cumulative | name" line.
+struct Line {
+  long long self_us;        // NOLINT: runtime/int
+  long long cumulative_us;  // NOLINT: runtime/int
+  int indent;
+  std::string name;
+};
+
+std::vector<Line> Parse(const std::string& out) {
+  std::vector<Line> lines;
+  size_t start = 0;
+  for (size_t end; (end = out.find('\n', start)) != std::string::npos;
+       start = end + 1) {
+    std::string s = out.substr(start, end - start);
+    Line line;
+    int name_at = 0;
+    EXPECT_EQ(sscanf(s.c_str(), "import time: %lld | %lld |%n",  // NOLINT
+                     &line.self_us, &line.cumulative_us, &name_at), 2) << s;
+    size_t name_start = s.find_first_not_of(' ', name_at);
+    line.indent = name_start - name_at - 1;  // After "| ".
+    line.name = s.substr(name_start);
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+void SleepMs(int ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+TEST(ImportTimerTest, StepsNestAndExcludeImportedModules) {
+  Py_Initialize();
+  // Read by the first ImportTimer (after Python's own imports are done).
+  setenv("PYTHONPROFILEIMPORTTIME", "1", 1);
+  testing::internal::CaptureStderr();
+  {
+    ImportTimer outer("m", "Init()");
+    outer.Step("a");
+    SleepMs(2);
+    {
+      // Another module imported by step a.
+      ImportTimer inner("n", "Ready()");
+      inner.Step("b");
+      SleepMs(3);
+    }
+    outer.Step("c");
+  }
+  std::vector<Line> lines = Parse(testing::internal::GetCapturedStderr());
+  ASSERT_EQ(lines.size(), 5u);
+  const Line& b = lines[0];
+  const Line& ready = lines[1];
+  const Line& a = lines[2];
+  const Line& c = lines[3];
+  const Line& init = lines[4];
+  EXPECT_EQ(b.name, "n: b");
+  EXPECT_EQ(ready.name, "n: Ready()");
+  EXPECT_EQ(a.name, "m: a");
+  EXPECT_EQ(c.name, "m: c");
+  EXPECT_EQ(init.name, "m: Init()");
+
+  // Steps are nested in their module, the module in the step importing it.
+  EXPECT_EQ(init.indent, 2);
+  EXPECT_EQ(a.indent, 4);
+  EXPECT_EQ(c.indent, 4);
+  EXPECT_EQ(ready.indent, 6);
+  EXPECT_EQ(b.indent, 8);
+
+  // Self time excludes the (cumulative) time of nested spans.
+  EXPECT_EQ(b.self_us, b.cumulative_us);
+  EXPECT_GE(b.cumulative_us, 3000);
+  EXPECT_EQ(ready.self_us, ready.cumulative_us - b.cumulative_us);
+  EXPECT_EQ(a.self_us, a.cumulative_us - ready.cumulative_us);
+  EXPECT_GE(a.self_us, 2000);
+  EXPECT_EQ(c.self_us, c.cumulative_us);
+  EXPECT_EQ(init.self_us,
+            init.cumulative_us - a.cumulative_us - c.cumulative_us);
+  EXPECT_GE(init.cumulative_us, a.cumulative_us + c.cumulative_us);
+}
+
+}  // namespace
+}  // namespace clif
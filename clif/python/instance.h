@@ -16,12 +16,38 @@
 #ifndef CLIF_PYTHON_INSTANCE_H_
 #define CLIF_PYTHON_INSTANCE_H_
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <typeinfo>
 
 namespace clif {
 
+// Users may report the heap memory owned by their objects to __sizeof__ (and
+// sys.getsizeof) and to allocation tracing by defining (found by ADL)
+//   size_t ClifOwnedHeapBytes(const T&);
+template <typename T>
+auto OwnedHeapBytes(const T& c, int)
+    -> decltype(static_cast<std::size_t>(ClifOwnedHeapBytes(c))) {
+  return ClifOwnedHeapBytes(c);
+}
+template <typename T>
+std::size_t OwnedHeapBytes(const T&, long) {  // NOLINT: runtime/int
+  return 0;
+}
+
+// Gets notified of the objects that Instances take and give up ownership of.
+// The CLIF runtime sets it to report them to tracemalloc, see
+// EnableAllocationTracing() in runtime.h.
+struct OwnershipObserver {
+  bool (*enabled)();
+  void (*owned)(const void* obj, std::size_t size, const std::type_info& type);
+  void (*released)(const void* obj, const std::type_info& type);
+};
+
+inline std::atomic<const OwnershipObserver*> ownership_observer{nullptr};
+
 // This class and the class UnOwnedResource are required so that two different
 // overloads of the Instance constructor, reflecting the respective object
 // ownership, can be defined. Since Instance is a template class, if one does
@@ -69,6 +95,11 @@ class Instance {
     maybe_deleter_ = maybe_deleter.get();
     ptr_ = std::shared_ptr<T>(unique.release(),
                               SharedMaybeDeleter(std::move(maybe_deleter)));
+    if (ptr_) {
+      const OwnershipObserver* o = ObserverIfEnabled();
+      if (o) o->owned(ptr_.get(), sizeof(T) + OwnedHeapBytes(*ptr_, 0),
+                      typeid(T));
+    }
   }
 
   // Creates an Instance that is essentially a copy of |shared|.
@@ -102,6 +133,9 @@ class Instance {
 
   bool operator!=(std::nullptr_t n) const { return ptr_ != n; }
 
+  // Returns true if this Instance deletes the pointee (unless renounced).
+  bool owned() const { return maybe_deleter_ != nullptr; }
+
   // Returns true if the ownership of the contained pointer could be renounced
   // successfully.
   bool Detach() {
@@ -147,11 +181,23 @@ class Instance {
       maybe_deleter_ = nullptr;
       T* obj = ptr_.get();
       ptr_.reset();
+      Released(obj);
       return obj;
     }
     return nullptr;
   }
 
+  static const OwnershipObserver* ObserverIfEnabled() {
+    const OwnershipObserver* o =
+        ownership_observer.load(std::memory_order_acquire);
+    return o && o->enabled() ? o : nullptr;
+  }
+
+  static void Released(T* obj) {
+    const OwnershipObserver* o = ObserverIfEnabled();
+    if (o) o->released(obj, typeid(T));
+  }
+
   // Provides a MaybeDelete(T*) function that may be disabled
   // (into a no-op) at some future point.
   class MaybeDeleter {
@@ -166,6 +212,7 @@ class Instance {
     // If enabled, deletes obj.
     void MaybeDelete(T* obj) {
       if (enabled_) {
+        Released(obj);
         delete obj;
       }
     }
@@ -36,10 +36,12 @@ class MyData {
 
 TEST(InstanceTest, TestCreationFromRawPointerOwn) {
   Instance<MyData> csp1(new MyData, OwnedResource());
+  EXPECT_TRUE(csp1.owned());
 
   std::unique_ptr<MyData> up1 = MakeStdUnique(&csp1);
   EXPECT_TRUE(up1);
   EXPECT_FALSE(csp1);
+  EXPECT_FALSE(csp1.owned());
   EXPECT_TRUE(csp1 == nullptr);
 
   Instance<MyData> csp2(up1.release(), OwnedResource());
@@ -54,6 +56,7 @@ TEST(InstanceTest, TestCreationFromRawPointerOwn) {
 TEST(InstanceTest, TestCreationFromRawPointerNotOwn) {
   std::unique_ptr<MyData> up(new MyData);
   Instance<MyData> csp1(up.get(),  UnOwnedResource());
+  EXPECT_FALSE(csp1.owned());
 
   std::unique_ptr<MyData> up1 = MakeStdUnique(&csp1);
   EXPECT_FALSE(up1);
@@ -103,6 +106,7 @@ TEST(InstanceTest, TestCreationFromUniquePointerWithDefaultDeleter) {
 TEST(InstanceTest, TestCreationFromSharedPointer) {
   std::shared_ptr<MyData> sp1(new MyData);
   Instance<MyData> csp1(sp1);
+  EXPECT_FALSE(csp1.owned());
 
   EXPECT_TRUE(sp1);
   EXPECT_TRUE(csp1);
@@ -119,4 +123,43 @@ TEST(InstanceTest, TestCreationFromSharedPointer) {
   EXPECT_TRUE(sp2);
 }
 
+struct TracedData {
+  int a;
+};
+
+size_t ClifOwnedHeapBytes(const TracedData&) { return 100; }
+
+const void* observed_obj;
+std::size_t observed_size;
+int observed_releases;
+
+TEST(InstanceTest, TestOwnershipObserver) {
+  static const OwnershipObserver kObserver = {
+      [] { return true; },
+      [](const void* obj, std::size_t size, const std::type_info&) {
+        observed_obj = obj;
+        observed_size = size;
+      },
+      [](const void* obj, const std::type_info&) {
+        EXPECT_EQ(obj, observed_obj);
+        ++observed_releases;
+      }};
+  ownership_observer.store(&kObserver);
+
+  Instance<TracedData> owned = MakeShared<TracedData>();
+  EXPECT_EQ(observed_obj, owned.get());
+  EXPECT_EQ(observed_size, sizeof(TracedData) + 100);
+  owned.Destruct();
+  EXPECT_EQ(observed_releases, 1);
+
+  Instance<TracedData> renounced = MakeShared<TracedData>();
+  std::unique_ptr<TracedData> up = MakeStdUnique(&renounced);
+  EXPECT_EQ(observed_releases, 2);
+
+  TracedData unowned_data;
+  Instance<TracedData> unowned(&unowned_data, UnOwnedResource());
+  EXPECT_NE(observed_obj, &unowned_data);
+  ownership_observer.store(nullptr);
+}
+
 }  // namespace clif
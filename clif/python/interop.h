@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_INTEROP_H_
+#define CLIF_PYTHON_INTEROP_H_
+
+/*
+Shared ownership protocol between wrappers generated by different CLIF
+backends (clif::Instance<T> of the Python C API backend and the pybind11
+smart_holder of the pybind11 backend) for the same C++ type T.
+
+Every wrapped class has a __clif_shared_ptr__() method returning a PyCapsule
+with a std::shared_ptr<T> sharing ownership with the wrapper. When a wrapper
+of the other backend is passed where T is expected, the converters get the
+C++ object from that capsule instead of failing or copying:
+- T* and T& arguments use the pointer, valid while the caller holds the
+  wrapper (as for native wrappers),
+- std::shared_ptr<T> arguments and adopted wrappers share ownership, so the
+  object lives as long as the last owner in either backend.
+Ownership can't be transferred (std::unique_ptr<T> arguments) across
+backends as the other backend can't renounce it.
+
+T must be the exact wrapped type: objects of derived classes are found
+through the as_Base() upcast capsules of the C API backend only.
+*/
+
+#include "Python.h"
+#include <cstring>
+#include <memory>
+#include <typeinfo>
+#include <utility>
+
+namespace clif {
+namespace interop {
+
+constexpr char kSharedPtrMethod[] = "__clif_shared_ptr__";
+constexpr char kSharedPtrCapsule[] = "clif::interop::SharedPtr";
+
+// The capsule payload.
+struct SharedPtr {
+  std::shared_ptr<void> ptr;
+  // typeid(T).name(), type_info objects are not unique across extensions.
+  const char* type;
+};
+
+inline void DeleteSharedPtr(PyObject* capsule) {
+  delete static_cast<SharedPtr*>(
+      PyCapsule_GetPointer(capsule, kSharedPtrCapsule));
+}
+
+// Returns a new __clif_shared_ptr__() capsule or nullptr with an exception.
+template <typename T>
+PyObject* SharedPtrCapsule(std::shared_ptr<T> ptr) {
+  if (!ptr) {
+    PyErr_SetString(PyExc_ValueError, "Missing value for wrapped C++ type");
+    return nullptr;
+  }
+  auto* payload = new SharedPtr{std::move(ptr), typeid(T).name()};
+  PyObject* capsule = PyCapsule_New(payload, kSharedPtrCapsule,
+                                    DeleteSharedPtr);
+  if (capsule == nullptr) delete payload;
+  return capsule;
+}
+
+// Gets the T owned by a wrapper from the other backend. Returns false without
+// an exception set if py does not provide a T, or with the exception raised by
+// its __clif_shared_ptr__() method.
+template <typename T>
+bool GetSharedPtr(PyObject* py, std::shared_ptr<T>* c) {
+  PyObject* method = PyObject_GetAttrString(py, kSharedPtrMethod);
+  if (method == nullptr) {
+    // Not a wrapper of the other backend.
+    if (PyErr_ExceptionMatches(PyExc_AttributeError)) PyErr_Clear();
+    return false;
+  }
+  PyObject* capsule = PyObject_CallObject(method, nullptr);
+  Py_DECREF(method);
+  if (capsule == nullptr) return false;
+  auto* payload = static_cast<SharedPtr*>(
+      PyCapsule_IsValid(capsule, kSharedPtrCapsule)
+          ? PyCapsule_GetPointer(capsule, kSharedPtrCapsule) : nullptr);
+  bool ok = payload != nullptr &&
+            std::strcmp(payload->type, typeid(T).name()) == 0;
+  if (ok) *c = std::static_pointer_cast<T>(payload->ptr);
+  Py_DECREF(capsule);
+  return ok;
+}
+
+}  // namespace interop
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_INTEROP_H_
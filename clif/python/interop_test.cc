@@ -0,0 +1,128 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "clif/python/interop.h"
+
+#include <Python.h>
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace clif {
+namespace interop {
+namespace {
+
+struct Shared {
+  int value = 0;
+};
+struct Other {};
+
+class InteropTest : public ::testing::Test {
+ protected:
+  InteropTest() {
+    Py_Initialize();
+    // Stand-ins for wrappers of the other backend.
+    PyObject* globals = PyDict_New();
+    PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins());
+    PyObject* result = PyRun_String(
+        "class Wrapper(object):\n"
+        "  def __init__(self, capsule):\n"
+        "    self.capsule = capsule\n"
+        "  def __clif_shared_ptr__(self):\n"
+        "    return self.capsule\n"
+        "class Raises(object):\n"
+        "  def __clif_shared_ptr__(self):\n"
+        "    raise RuntimeError('not now')\n",
+        Py_file_input, globals, globals);
+    EXPECT_NE(result, nullptr);
+    Py_XDECREF(result);
+    wrapper_ = PyDict_GetItemString(globals, "Wrapper");
+    raises_ = PyDict_GetItemString(globals, "Raises");
+    Py_XINCREF(wrapper_);
+    Py_XINCREF(raises_);
+    Py_DECREF(globals);
+  }
+  ~InteropTest() override {
+    Py_XDECREF(wrapper_);
+    Py_XDECREF(raises_);
+  }
+
+  // Returns a new Wrapper sharing |ptr|.
+  PyObject* Wrap(std::shared_ptr<Shared> ptr) {
+    PyObject* capsule = SharedPtrCapsule(std::move(ptr));
+    if (capsule == nullptr) return nullptr;
+    PyObject* py = PyObject_CallFunctionObjArgs(wrapper_, capsule, nullptr);
+    Py_DECREF(capsule);
+    return py;
+  }
+
+  PyObject* wrapper_;
+  PyObject* raises_;
+};
+
+TEST_F(InteropTest, SharesOwnership) {
+  auto original = std::make_shared<Shared>();
+  original->value = 7;
+  PyObject* py = Wrap(original);
+  ASSERT_NE(py, nullptr);
+  std::shared_ptr<Shared> c;
+  EXPECT_TRUE(GetSharedPtr(py, &c));
+  EXPECT_FALSE(PyErr_Occurred());
+  EXPECT_EQ(c.get(), original.get());
+  original.reset();
+  Py_DECREF(py);
+  // The last owner keeps the object alive.
+  ASSERT_EQ(c.use_count(), 1);
+  EXPECT_EQ(c->value, 7);
+}
+
+TEST_F(InteropTest, NullIsNotShared) {
+  EXPECT_EQ(Wrap(nullptr), nullptr);
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_ValueError));
+  PyErr_Clear();
+}
+
+TEST_F(InteropTest, OtherTypeIsNotAccepted) {
+  PyObject* py = Wrap(std::make_shared<Shared>());
+  ASSERT_NE(py, nullptr);
+  std::shared_ptr<Other> c;
+  EXPECT_FALSE(GetSharedPtr(py, &c));
+  EXPECT_FALSE(PyErr_Occurred());
+  EXPECT_EQ(c, nullptr);
+  Py_DECREF(py);
+}
+
+TEST_F(InteropTest, ObjectWithoutMethodIsNotAccepted) {
+  PyObject* py = PyLong_FromLong(1);
+  std::shared_ptr<Shared> c;
+  EXPECT_FALSE(GetSharedPtr(py, &c));
+  EXPECT_FALSE(PyErr_Occurred());
+  Py_DECREF(py);
+}
+
+TEST_F(InteropTest, MethodErrorIsKept) {
+  PyObject* py = PyObject_CallFunctionObjArgs(raises_, nullptr);
+  ASSERT_NE(py, nullptr);
+  std::shared_ptr<Shared> c;
+  EXPECT_FALSE(GetSharedPtr(py, &c));
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_RuntimeError));
+  PyErr_Clear();
+  Py_DECREF(py);
+}
+
+}  // namespace
+}  // namespace interop
+}  // namespace clif
@@ -0,0 +1,683 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_MEMBER_VIEW_H_
+#define CLIF_PYTHON_MEMBER_VIEW_H_
+
+/*
+Views of container members, returned by the getter of a .clif var declared
+with the @view decorator instead of a list/dict/set copy of the member. A view
+holds a shared_ptr aliasing the member (see MakeStdShared), so it keeps the
+owning instance alive and reads and writes the C++ container in place:
+
+  sequences  (std::vector, std::deque, std::array, ...)
+      len(v), v[i], v[i:j] (a list), v[i] = x, x in v, iteration
+      and, if the container has push_back:
+      del v[i], v += iterable, append, extend, insert, pop, clear
+  mappings   (std::map, std::unordered_map, ...: key_type and mapped_type)
+      len(m), m[k], m[k] = x, del m[k], k in m, iteration over keys,
+      get, keys, values, items (lists), clear
+  sets       (std::set, std::unordered_set, ...: key_type only)
+      len(s), x in s, iteration, add, discard, clear
+
+Only the container is shared: elements are converted on each access like
+those of a returned copy, so v[0].x = 1 does not change a wrapped element.
+A view compares equal to the list/dict/set it would otherwise be.
+
+Iterators hold no C++ iterator across Python code, which may change or
+replace the container: a sequence iterator keeps the index of the next
+element and stops at the current end, an associative one keeps the last key
+it returned and finds its successor on each step (upper_bound if the
+container is ordered). Iterating over an associative container raises
+RuntimeError if its size changed or, if unordered, the last key was erased.
+
+Assigning a view to a @view var copies its container (see Assign).
+*/
+
+#include <Python.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "clif/python/container.h"
+#include "clif/python/postconv.h"
+#include "clif/python/stltypes.h"
+
+namespace clif {
+namespace view {
+
+// Clif_PyObjFrom(Member<C>) returns a view of *c.
+template <typename C>
+struct Member {
+  std::shared_ptr<C> c;
+};
+
+template <typename C>
+Member<C> Of(std::shared_ptr<C> c) {
+  return Member<C>{std::move(c)};
+}
+
+namespace internal {
+
+template <typename C, typename = void>
+struct IsResizable : std::false_type {};
+template <typename C>
+struct IsResizable<C, std::void_t<decltype(std::declval<C&>().push_back(
+                          std::declval<typename C::value_type>()))>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct IsEqualityComparable : std::false_type {};
+template <typename T>
+struct IsEqualityComparable<
+    T, std::void_t<decltype(static_cast<bool>(std::declval<const T&>() ==
+                                              std::declval<const T&>()))>>
+    : std::true_type {};
+
+// Converts |py| to T and passes it to |use|. Returns false on errors.
+template <typename T, typename Use>
+bool WithValue(PyObject* py, Use use) {
+  using Item = std::remove_const_t<T>;
+  if constexpr (std::is_default_constructible_v<Item>) {
+    Item item;
+    if (!Clif_PyObjAs(py, &item)) return false;
+    use(std::move(item));
+  } else {
+    Item* item;
+    if (!Clif_PyObjAs(py, &item)) return false;
+    use(Item(*item));
+  }
+  return true;
+}
+
+template <typename C, bool is_mapping>
+struct ElementOf {
+  using type = typename C::value_type;
+};
+template <typename C>
+struct ElementOf<C, true> {
+  using type = typename C::key_type;
+};
+
+template <typename C, typename = void>
+struct IsOrdered : std::false_type {};
+template <typename C>
+struct IsOrdered<C, std::void_t<typename C::key_compare>> : std::true_type {};
+
+// Iteration position: the index of the next element of a sequence, the last
+// key returned from an associative container.
+template <typename C, bool is_associative>
+struct PositionOf {
+  using type = std::size_t;
+};
+template <typename C>
+struct PositionOf<C, true> {
+  using type = std::optional<typename C::key_type>;
+};
+
+template <typename C>
+struct ViewObject {
+  PyObject_HEAD
+  std::shared_ptr<C> c;
+  py::PostConv pc;
+};
+
+template <typename C>
+struct IterObject {
+  PyObject_HEAD
+  std::shared_ptr<C> c;
+  py::PostConv pc;
+  typename PositionOf<C,
+                      container::internal::HasKeyType<C>::value>::type pos;
+  std::size_t size;
+  bool done;
+};
+
+template <typename C>
+class View {
+ public:
+  static constexpr bool kAssociative =
+      container::internal::HasKeyType<C>::value;
+  static constexpr bool kMapping = container::internal::HasMappedType<C>::value;
+  static constexpr bool kResizable = !kAssociative && IsResizable<C>::value;
+  using Position = typename PositionOf<C, kAssociative>::type;
+  // Elements of sequences and sets, keys of mappings.
+  using Item = typename ElementOf<C, kMapping>::type;
+
+  // Returns the (lazily created) view type of C, or nullptr on errors.
+  static PyTypeObject* Type() {
+    static PyTypeObject* type = MakeType();
+    return type;
+  }
+
+  static PyObject* New(std::shared_ptr<C> c, const py::PostConv& pc) {
+    PyTypeObject* type = Type();
+    if (type == nullptr) return nullptr;
+    auto* v = PyObject_New(ViewObject<C>, type);
+    if (v == nullptr) return nullptr;
+    new (&v->c) std::shared_ptr<C>(std::move(c));
+    new (&v->pc) py::PostConv(pc);
+    return reinterpret_cast<PyObject*>(v);
+  }
+
+  // Returns the viewed container if |py| is a view of a C, else nullptr.
+  static C* Get(PyObject* py) {
+    PyTypeObject* type = Type();
+    if (type == nullptr) {
+      PyErr_Clear();
+      return nullptr;
+    }
+    if (Py_TYPE(py) != type) return nullptr;
+    return reinterpret_cast<ViewObject<C>*>(py)->c.get();
+  }
+
+ private:
+  static ViewObject<C>* Self(PyObject* self) {
+    return reinterpret_cast<ViewObject<C>*>(self);
+  }
+  static const C& Cont(PyObject* self) { return *Self(self)->c; }
+  static C& MutableCont(PyObject* self) { return *Self(self)->c; }
+  static const py::PostConv& Pc(PyObject* self) { return Self(self)->pc; }
+
+  // The list/dict/set the getter would return without @view.
+  static PyObject* Copy(PyObject* self) {
+    return Clif_PyObjFrom(Cont(self), Pc(self));
+  }
+
+  static PyTypeObject* MakeType() {
+    const char* name = kMapping       ? "clif.MappingView"
+                       : kAssociative ? "clif.SetView"
+                                      : "clif.SequenceView";
+    std::vector<PyType_Slot> slots = {
+        {Py_tp_dealloc, reinterpret_cast<void*>(&Dealloc)},
+        {Py_tp_repr, reinterpret_cast<void*>(&Repr)},
+        {Py_tp_hash, reinterpret_cast<void*>(&PyObject_HashNotImplemented)},
+        {Py_tp_richcompare, reinterpret_cast<void*>(&RichCompare)},
+        {Py_tp_iter, reinterpret_cast<void*>(&Iter)},
+        {Py_mp_length, reinterpret_cast<void*>(&Length)},
+    };
+    if constexpr (!kAssociative || kMapping) {
+      slots.push_back({Py_mp_subscript, reinterpret_cast<void*>(&Subscript)});
+      slots.push_back(
+          {Py_mp_ass_subscript, reinterpret_cast<void*>(&AssSubscript)});
+    }
+    if constexpr (kAssociative || (IsEqualityComparable<Item>::value &&
+                                   std::is_default_constructible_v<Item>)) {
+      slots.push_back({Py_sq_contains, reinterpret_cast<void*>(&Contains)});
+    }
+    if constexpr (kResizable) {
+      slots.push_back(
+          {Py_sq_inplace_concat, reinterpret_cast<void*>(&InplaceConcat)});
+    }
+    if (PyMethodDef* methods = Methods()) {
+      slots.push_back({Py_tp_methods, methods});
+    }
+    slots.push_back({0, nullptr});
+    PyType_Spec spec = {name, sizeof(ViewObject<C>), 0, Py_TPFLAGS_DEFAULT,
+                        slots.data()};
+    auto* type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+    // Views are only made by New.
+    if (type != nullptr) type->tp_new = nullptr;
+    return type;
+  }
+
+  static void Dealloc(PyObject* self) {
+    auto* v = Self(self);
+    v->c.~shared_ptr();
+    v->pc.~PostConv();
+    PyTypeObject* type = Py_TYPE(self);
+    PyObject_Del(self);
+    Py_DECREF(type);
+  }
+
+  static PyObject* Repr(PyObject* self) {
+    PyObject* copy = Copy(self);
+    if (copy == nullptr) return nullptr;
+    PyObject* repr =
+        PyUnicode_FromFormat("%s(%R)", Py_TYPE(self)->tp_name, copy);
+    Py_DECREF(copy);
+    return repr;
+  }
+
+  static PyObject* RichCompare(PyObject* self, PyObject* other, int op) {
+    if (op != Py_EQ && op != Py_NE) Py_RETURN_NOTIMPLEMENTED;
+    PyObject* a = Copy(self);
+    if (a == nullptr) return nullptr;
+    PyObject* b;
+    if (Py_TYPE(other) == Py_TYPE(self)) {
+      b = Copy(other);
+      if (b == nullptr) {
+        Py_DECREF(a);
+        return nullptr;
+      }
+    } else {
+      b = other;
+      Py_INCREF(b);
+    }
+    PyObject* r = PyObject_RichCompare(a, b, op);
+    Py_DECREF(a);
+    Py_DECREF(b);
+    return r;
+  }
+
+  static Py_ssize_t Length(PyObject* self) {
+    return static_cast<Py_ssize_t>(Cont(self).size());
+  }
+
+  // Sets *i to the index |py| of a sequence of |size| elements.
+  static bool AsIndex(PyObject* py, std::size_t size, std::size_t* i) {
+    Py_ssize_t n = PyNumber_AsSsize_t(py, PyExc_IndexError);
+    if (n == -1 && PyErr_Occurred()) return false;
+    if (n < 0) n += static_cast<Py_ssize_t>(size);
+    if (n < 0 || static_cast<std::size_t>(n) >= size) {
+      PyErr_SetString(PyExc_IndexError, "index out of range");
+      return false;
+    }
+    *i = static_cast<std::size_t>(n);
+    return true;
+  }
+
+  static PyObject* Subscript(PyObject* self, PyObject* key) {
+    const C& c = Cont(self);
+    if constexpr (kMapping) {
+      typename C::key_type k;
+      int is_key = container::AsKey(key, &k);
+      if (is_key < 0) return nullptr;
+      if (is_key) {
+        auto it = c.find(k);
+        if (it != c.end()) return Clif_PyObjFrom(it->second, Pc(self).Get(1));
+      }
+      PyErr_SetObject(PyExc_KeyError, key);
+      return nullptr;
+    } else {
+      if (PySlice_Check(key)) {
+        Py_ssize_t start, stop, step;
+        if (PySlice_Unpack(key, &start, &stop, &step) < 0) return nullptr;
+        Py_ssize_t n = PySlice_AdjustIndices(static_cast<Py_ssize_t>(c.size()),
+                                             &start, &stop, step);
+        PyObject* list = PyList_New(n);
+        if (list == nullptr) return nullptr;
+        for (Py_ssize_t i = 0; i < n; ++i, start += step) {
+          PyObject* item = Clif_PyObjFrom(
+              c[static_cast<std::size_t>(start)], Pc(self).Get(0));
+          if (item == nullptr) {
+            Py_DECREF(list);
+            return nullptr;
+          }
+          PyList_SET_ITEM(list, i, item);
+        }
+        return list;
+      }
+      if (!PyIndex_Check(key)) {
+        PyErr_Format(PyExc_TypeError, "indices must be integers, not %s",
+                     Py_TYPE(key)->tp_name);
+        return nullptr;
+      }
+      std::size_t i;
+      if (!AsIndex(key, c.size(), &i)) return nullptr;
+      return Clif_PyObjFrom(c[i], Pc(self).Get(0));
+    }
+  }
+
+  static int AssSubscript(PyObject* self, PyObject* key, PyObject* value) {
+    C& c = MutableCont(self);
+    if constexpr (kMapping) {
+      typename C::key_type k;
+      if (value == nullptr) {
+        int is_key = container::AsKey(key, &k);
+        if (is_key < 0) return -1;
+        if (is_key && c.erase(k)) return 0;
+        PyErr_SetObject(PyExc_KeyError, key);
+        return -1;
+      }
+      if (!Clif_PyObjAs(key, &k)) return -1;
+      return WithValue<typename C::mapped_type>(
+                 value,
+                 [&c, &k](typename C::mapped_type&& v) {
+                   c.insert_or_assign(std::move(k), std::move(v));
+                 })
+                 ? 0
+                 : -1;
+    } else {
+      if (!PyIndex_Check(key)) {
+        PyErr_Format(PyExc_TypeError,
+                     "indices must be integers, not %s (slice assignment is "
+                     "not supported)",
+                     Py_TYPE(key)->tp_name);
+        return -1;
+      }
+      std::size_t i;
+      if (!AsIndex(key, c.size(), &i)) return -1;
+      if (value == nullptr) {
+        if constexpr (kResizable) {
+          c.erase(c.begin() + i);
+          return 0;
+        } else {
+          PyErr_SetString(PyExc_TypeError,
+                          "cannot delete items of a fixed size container");
+          return -1;
+        }
+      }
+      return WithValue<Item>(value, [&c, i](Item&& v) { c[i] = std::move(v); })
+                 ? 0
+                 : -1;
+    }
+  }
+
+  static int Contains(PyObject* self, PyObject* key) {
+    const C& c = Cont(self);
+    std::remove_const_t<Item> k;
+    int is_key = container::AsKey(key, &k);
+    if (is_key <= 0) return is_key;
+    if constexpr (kAssociative) {
+      return c.find(k) != c.end() ? 1 : 0;
+    } else {
+      return std::find(c.begin(), c.end(), k) != c.end() ? 1 : 0;
+    }
+  }
+
+  static PyObject* InplaceConcat(PyObject* self, PyObject* other) {
+    PyObject* none = Extend(self, other);
+    if (none == nullptr) return nullptr;
+    Py_DECREF(none);
+    Py_INCREF(self);
+    return self;
+  }
+
+  static PyObject* Extend(PyObject* self, PyObject* iterable) {
+    // Convert all items first: a failure leaves the container unchanged and
+    // v.extend(v) does not iterate over a growing container.
+    std::vector<std::remove_const_t<Item>> items;
+    if (!py::IterToCont<Item>(iterable, [&items](Item&& v) {
+          items.push_back(std::move(v));
+        })) {
+      return nullptr;
+    }
+    C& c = MutableCont(self);
+    c.insert(c.end(), std::make_move_iterator(items.begin()),
+             std::make_move_iterator(items.end()));
+    Py_RETURN_NONE;
+  }
+
+  static PyObject* Append(PyObject* self, PyObject* value) {
+    C& c = MutableCont(self);
+    if (!WithValue<Item>(value, [&c](Item&& v) { c.push_back(std::move(v)); }))
+      return nullptr;
+    Py_RETURN_NONE;
+  }
+
+  static PyObject* Insert(PyObject* self, PyObject* args) {
+    Py_ssize_t i;
+    PyObject* value;
+    if (!PyArg_ParseTuple(args, "nO:insert", &i, &value)) return nullptr;
+    C& c = MutableCont(self);
+    // Like list.insert, out of range indices insert at either end.
+    const auto size = static_cast<Py_ssize_t>(c.size());
+    if (i < 0) i = std::max<Py_ssize_t>(i + size, 0);
+    i = std::min(i, size);
+    if (!WithValue<Item>(value, [&c, i](Item&& v) {
+          c.insert(c.begin() + i, std::move(v));
+        })) {
+      return nullptr;
+    }
+    Py_RETURN_NONE;
+  }
+
+  static PyObject* Pop(PyObject* self, PyObject* args) {
+    Py_ssize_t i = -1;
+    if (!PyArg_ParseTuple(args, "|n:pop", &i)) return nullptr;
+    C& c = MutableCont(self);
+    if (c.empty()) {
+      PyErr_SetString(PyExc_IndexError, "pop from empty container");
+      return nullptr;
+    }
+    if (i < 0) i += static_cast<Py_ssize_t>(c.size());
+    if (i < 0 || static_cast<std::size_t>(i) >= c.size()) {
+      PyErr_SetString(PyExc_IndexError, "pop index out of range");
+      return nullptr;
+    }
+    PyObject* item =
+        Clif_PyObjFrom(static_cast<const C&>(c)[i], Pc(self).Get(0));
+    if (item != nullptr) c.erase(c.begin() + i);
+    return item;
+  }
+
+  static PyObject* Clear(PyObject* self, PyObject*) {
+    MutableCont(self).clear();
+    Py_RETURN_NONE;
+  }
+
+  static PyObject* GetMethod(PyObject* self, PyObject* args) {
+    PyObject* key;
+    PyObject* default_value = Py_None;
+    if (!PyArg_UnpackTuple(args, "get", 1, 2, &key, &default_value)) {
+      return nullptr;
+    }
+    const C& c = Cont(self);
+    typename C::key_type k;
+    int is_key = container::AsKey(key, &k);
+    if (is_key < 0) return nullptr;
+    if (is_key) {
+      auto it = c.find(k);
+      if (it != c.end()) return Clif_PyObjFrom(it->second, Pc(self).Get(1));
+    }
+    Py_INCREF(default_value);
+    return default_value;
+  }
+
+  // Returns a list of f(element) for the elements of the container.
+  template <typename F>
+  static PyObject* ListOf(PyObject* self, F f) {
+    const C& c = Cont(self);
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(c.size()));
+    if (list == nullptr) return nullptr;
+    Py_ssize_t i = 0;
+    for (const auto& e : c) {
+      PyObject* item = f(e);
+      if (item == nullptr) {
+        Py_DECREF(list);
+        return nullptr;
+      }
+      PyList_SET_ITEM(list, i++, item);
+    }
+    return list;
+  }
+
+  static PyObject* Keys(PyObject* self, PyObject*) {
+    const py::PostConv& pc = Pc(self).Get(0);
+    return ListOf(self, [&pc](const typename C::value_type& e) {
+      return Clif_PyObjFrom(e.first, pc);
+    });
+  }
+
+  static PyObject* Values(PyObject* self, PyObject*) {
+    const py::PostConv& pc = Pc(self).Get(1);
+    return ListOf(self, [&pc](const typename C::value_type& e) {
+      return Clif_PyObjFrom(e.second, pc);
+    });
+  }
+
+  static PyObject* Items(PyObject* self, PyObject*) {
+    const py::PostConv& pc = Pc(self);
+    return ListOf(self, [&pc](const typename C::value_type& e) {
+      return Clif_PyObjFrom(e, pc);
+    });
+  }
+
+  static PyObject* Add(PyObject* self, PyObject* value) {
+    C& c = MutableCont(self);
+    if (!WithValue<Item>(value, [&c](Item&& v) { c.insert(std::move(v)); }))
+      return nullptr;
+    Py_RETURN_NONE;
+  }
+
+  static PyObject* Discard(PyObject* self, PyObject* value) {
+    std::remove_const_t<Item> k;
+    int is_key = container::AsKey(value, &k);
+    if (is_key < 0) return nullptr;
+    if (is_key) MutableCont(self).erase(k);
+    Py_RETURN_NONE;
+  }
+
+  static PyMethodDef* Methods() {
+    if constexpr (kMapping) {
+      static PyMethodDef methods[] = {
+          {"get", &GetMethod, METH_VARARGS,
+           "get(key, default=None)\n  Returns the value of key or default."},
+          {"keys", &Keys, METH_NOARGS, "keys()\n  Returns a list of keys."},
+          {"values", &Values, METH_NOARGS,
+           "values()\n  Returns a list of values."},
+          {"items", &Items, METH_NOARGS,
+           "items()\n  Returns a list of (key, value) pairs."},
+          {"clear", &Clear, METH_NOARGS, "clear()\n  Removes all items."},
+          {}};
+      return methods;
+    } else if constexpr (kAssociative) {
+      static PyMethodDef methods[] = {
+          {"add", &Add, METH_O, "add(x)\n  Adds x."},
+          {"discard", &Discard, METH_O, "discard(x)\n  Removes x if present."},
+          {"clear", &Clear, METH_NOARGS, "clear()\n  Removes all items."},
+          {}};
+      return methods;
+    } else if constexpr (kResizable) {
+      static PyMethodDef methods[] = {
+          {"append", &Append, METH_O, "append(x)\n  Appends x."},
+          {"extend", &Extend, METH_O,
+           "extend(iterable)\n  Appends the items of iterable."},
+          {"insert", &Insert, METH_VARARGS,
+           "insert(index, x)\n  Inserts x before index."},
+          {"pop", &Pop, METH_VARARGS,
+           "pop(index=-1)\n  Removes and returns the item at index."},
+          {"clear", &Clear, METH_NOARGS, "clear()\n  Removes all items."},
+          {}};
+      return methods;
+    } else {
+      return nullptr;
+    }
+  }
+
+  static PyObject* Iter(PyObject* self) {
+    PyTypeObject* type = IterType();
+    if (type == nullptr) return nullptr;
+    auto* it = PyObject_New(IterObject<C>, type);
+    if (it == nullptr) return nullptr;
+    new (&it->c) std::shared_ptr<C>(Self(self)->c);
+    new (&it->pc) py::PostConv(Pc(self));
+    new (&it->pos) Position();
+    it->size = Cont(self).size();
+    it->done = false;
+    return reinterpret_cast<PyObject*>(it);
+  }
+
+  static PyTypeObject* IterType() {
+    static PyTypeObject* type = [] {
+      PyType_Slot slots[] = {
+          {Py_tp_dealloc, reinterpret_cast<void*>(&IterDealloc)},
+          {Py_tp_iter, reinterpret_cast<void*>(&PyObject_SelfIter)},
+          {Py_tp_iternext, reinterpret_cast<void*>(&IterNext)},
+          {0, nullptr}};
+      PyType_Spec spec = {"clif.ViewIterator", sizeof(IterObject<C>), 0,
+                          Py_TPFLAGS_DEFAULT, slots};
+      auto* type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+      if (type != nullptr) type->tp_new = nullptr;
+      return type;
+    }();
+    return type;
+  }
+
+  static void IterDealloc(PyObject* self) {
+    auto* it = reinterpret_cast<IterObject<C>*>(self);
+    it->c.~shared_ptr();
+    it->pc.~PostConv();
+    it->pos.~Position();
+    PyTypeObject* type = Py_TYPE(self);
+    PyObject_Del(self);
+    Py_DECREF(type);
+  }
+
+  static PyObject* IterNext(PyObject* self) {
+    auto* it = reinterpret_cast<IterObject<C>*>(self);
+    if (it->done) return nullptr;
+    const C& c = *it->c;
+    if constexpr (kAssociative) {
+      if (c.size() != it->size) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "container changed size during iteration");
+        return nullptr;
+      }
+      typename C::const_iterator e;
+      if (!it->pos) {
+        e = c.cbegin();
+      } else if constexpr (IsOrdered<C>::value) {
+        e = c.upper_bound(*it->pos);
+      } else {
+        e = c.find(*it->pos);
+        if (e == c.cend()) {
+          PyErr_SetString(PyExc_RuntimeError,
+                          "container changed during iteration");
+          return nullptr;
+        }
+        ++e;
+      }
+      if (e == c.cend()) {
+        it->done = true;
+        return nullptr;
+      }
+      if constexpr (kMapping) {
+        it->pos = e->first;
+      } else {
+        it->pos = *e;
+      }
+      return Clif_PyObjFrom(*it->pos, it->pc.Get(0));
+    } else {
+      if (it->pos >= c.size()) {
+        it->done = true;
+        return nullptr;
+      }
+      return Clif_PyObjFrom(c[it->pos++], it->pc.Get(0));
+    }
+  }
+};
+
+}  // namespace internal
+
+template <typename C>
+PyObject* Clif_PyObjFrom(const Member<C>& m, const py::PostConv& pc) {
+  return internal::View<C>::New(m.c, pc);
+}
+
+// Copies the container viewed by |py| to *c if |py| is a view of a C (a no-op
+// if it views *c itself) and returns true, else returns false with no error
+// set, for the caller to convert |py| with Clif_PyObjAs. Unlike
+// Clif_PyObjAs(py, &vector) this does not clear *c before reading |py|.
+template <typename C>
+bool Assign(PyObject* py, C* c) {
+  C* src = internal::View<C>::Get(py);
+  if (src == nullptr) return false;
+  if (src != c) *c = *src;
+  return true;
+}
+
+}  // namespace view
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_MEMBER_VIEW_H_
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "clif/python/member_view.h"
+
+#include <Python.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "clif/python/runtime.h"
+
+namespace clif {
+namespace view {
+namespace {
+
+class MemberViewTest : public ::testing::Test {
+ protected:
+  MemberViewTest() { Py_Initialize(); }
+
+  // Runs Python |code| with |view| bound to v, returns the error if any.
+  static std::string Run(PyObject* view, const char* code) {
+    if (view == nullptr) return python::ExcStr();
+    PyObject* globals = PyDict_New();
+    PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins());
+    PyDict_SetItemString(globals, "v", view);
+    Py_DECREF(view);
+    PyObject* r = PyRun_String(code, Py_file_input, globals, globals);
+    Py_DECREF(globals);
+    if (r == nullptr) return python::ExcStr();
+    Py_DECREF(r);
+    return "";
+  }
+};
+
+TEST_F(MemberViewTest, Vector) {
+  auto c = std::make_shared<std::vector<int>>(std::vector<int>{1, 2, 3});
+  EXPECT_EQ(Run(Clif_PyObjFrom(Of(c), {}), R"(
+assert len(v) == 3
+assert v[0] == 1 and v[-1] == 3 and v[1:] == [2, 3]
+assert 2 in v and 4 not in v and 'x' not in v
+assert list(v) == [1, 2, 3] and v == [1, 2, 3]
+v[0] = 10
+v.append(4)
+v += [5]
+v.insert(0, 0)
+assert v.pop() == 5
+del v[1]
+try:
+  v[9]
+except IndexError:
+  pass
+else:
+  raise AssertionError('v[9]')
+try:
+  v.append('x')
+except TypeError:
+  pass
+else:
+  raise AssertionError('append')
+)"), "");
+  EXPECT_EQ(*c, (std::vector<int>{0, 2, 3, 4}));
+  EXPECT_EQ(c.use_count(), 1);
+}
+
+TEST_F(MemberViewTest, Array) {
+  auto c = std::make_shared<std::array<int, 2>>();
+  EXPECT_EQ(Run(Clif_PyObjFrom(Of(c), {}), R"(
+v[1] = 7
+assert v == [0, 7]
+assert not hasattr(v, 'append')
+try:
+  del v[0]
+except TypeError:
+  pass
+else:
+  raise AssertionError('del')
+)"), "");
+  EXPECT_EQ((*c)[1], 7);
+}
+
+TEST_F(MemberViewTest, Map) {
+  using Map = std::map<std::string, int>;
+  auto c = std::make_shared<Map>(Map{{"a", 1}});
+  EXPECT_EQ(Run(Clif_PyObjFrom(Of(c), {}), R"(
+assert v['a'] == 1 and 'a' in v and 1 not in v
+v['b'] = 2
+assert v.get('c') is None and v.get('b') == 2
+# Without a postconversion (str in .clif) std::string converts to bytes.
+assert v.keys() == [b'a', b'b'] and v.values() == [1, 2]
+assert v.items() == [(b'a', 1), (b'b', 2)]
+assert v == {b'a': 1, b'b': 2}
+del v['a']
+try:
+  for k in v:
+    v['c'] = 3
+except RuntimeError:
+  pass
+else:
+  raise AssertionError('iteration')
+try:
+  v['z']
+except KeyError:
+  pass
+else:
+  raise AssertionError('v[z]')
+)"), "");
+  EXPECT_EQ(*c, (Map{{"b", 2}, {"c", 3}}));
+}
+
+TEST_F(MemberViewTest, Set) {
+  auto c = std::make_shared<std::set<int>>(std::set<int>{1});
+  EXPECT_EQ(Run(Clif_PyObjFrom(Of(c), {}), R"(
+v.add(2)
+v.discard(1)
+v.discard('x')
+assert 2 in v and len(v) == 1 and v == {2}
+assert repr(v) == 'clif.SetView({2})', repr(v)
+)"), "");
+  EXPECT_EQ(*c, (std::set<int>{2}));
+}
+
+TEST_F(MemberViewTest, MutateWhileIterating) {
+  // Erasing the next element would invalidate a kept std::set iterator.
+  auto s = std::make_shared<std::set<int>>(std::set<int>{1, 2});
+  EXPECT_EQ(Run(Clif_PyObjFrom(Of(s), {}), R"(
+seen = []
+for x in v:
+  seen.append(x)
+  if x == 1:
+    v.discard(2)
+    v.add(102)
+assert seen == [1, 102], seen
+)"), "");
+  using UnorderedSet = std::unordered_set<int>;
+  auto u = std::make_shared<UnorderedSet>(UnorderedSet{1, 2, 3});
+  EXPECT_EQ(Run(Clif_PyObjFrom(Of(u), {}), R"(
+try:
+  for x in v:
+    v.discard(x)
+    v.add(x + 100)
+except RuntimeError:
+  pass
+else:
+  raise AssertionError('iteration')
+)"), "");
+  using Map = std::map<int, int>;
+  auto m = std::make_shared<Map>(Map{{1, 1}, {2, 2}});
+  auto other = std::make_shared<Map>(Map{{0, 0}, {5, 5}});
+  PyObject* view = Clif_PyObjFrom(Of(m), {});
+  ASSERT_NE(view, nullptr);
+  PyObject* it = PyObject_GetIter(view);
+  ASSERT_NE(it, nullptr);
+  PyObject* key = PyIter_Next(it);
+  ASSERT_NE(key, nullptr);
+  EXPECT_EQ(PyLong_AsLong(key), 1);
+  Py_DECREF(key);
+  // Like the setter of a @view var assigning another view.
+  PyObject* other_view = Clif_PyObjFrom(Of(other), {});
+  EXPECT_TRUE(Assign(other_view, m.get()));
+  Py_DECREF(other_view);
+  key = PyIter_Next(it);
+  ASSERT_NE(key, nullptr);
+  EXPECT_EQ(PyLong_AsLong(key), 5);
+  Py_DECREF(key);
+  EXPECT_EQ(PyIter_Next(it), nullptr);
+  EXPECT_EQ(PyErr_Occurred(), nullptr);
+  Py_DECREF(it);
+  Py_DECREF(view);
+}
+
+TEST_F(MemberViewTest, Assign) {
+  auto a = std::make_shared<std::vector<int>>(std::vector<int>{1, 2});
+  auto b = std::make_shared<std::vector<int>>();
+  PyObject* view = Clif_PyObjFrom(Of(a), {});
+  ASSERT_NE(view, nullptr);
+  EXPECT_TRUE(Assign(view, a.get()));
+  EXPECT_EQ(*a, (std::vector<int>{1, 2}));
+  EXPECT_TRUE(Assign(view, b.get()));
+  EXPECT_EQ(*b, (std::vector<int>{1, 2}));
+  std::set<int> s;
+  EXPECT_FALSE(Assign(view, &s));
+  EXPECT_FALSE(Assign(Py_None, b.get()));
+  EXPECT_EQ(PyErr_Occurred(), nullptr);
+  Py_DECREF(view);
+}
+
+}  // namespace
+}  // namespace view
+}  // namespace clif
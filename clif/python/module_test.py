@@ -145,6 +145,102 @@ class ModuleTest(unittest.TestCase):
       }"""))
     # pylint: enable=g-long-ternary
 
+  def testCApi(self):
+    ast = ast_pb2.AST()
+    text_format.Parse("""
+      source: "my.clif"
+      decls {
+        decltype: CLASS
+        class_ {
+          name {
+            native: "K"
+            cpp_name: "::ns::K"
+          }
+          cpp_copyable: false
+        }
+        namespace_: "ns"
+      }
+      decls {
+        decltype: FUNC
+        func {
+          name {
+            native: "f"
+            cpp_name: "::ns::f"
+          }
+          params {
+            name {
+              native: "k"
+            }
+            type {
+              lang_type: "K"
+              cpp_type: "::ns::K"
+            }
+            cpp_exact_type: "const ::ns::K &"
+          }
+          returns {
+            type {
+              lang_type: "int"
+              cpp_type: "int"
+            }
+          }
+          returns {
+            name {
+              native: "s"
+            }
+            type {
+              lang_type: "str"
+              cpp_type: "::std::string"
+            }
+          }
+        }
+      }
+    """, ast)
+    m = pyext.Module('my.test', c_api=True)
+    base = '\n'.join(m.GenerateBase(ast, []))
+    self.assertIn('if (PyModule_AddObject(module, "_C_API", CApiCapsule()) < 0)'
+                  ' goto err;', base)
+    self.assertIn(textwrap.dedent("""\
+      static const CApi c_api = {
+        {::clif::capi::kVersion, CApi::kLayout},
+        pyK::ThisPtr,
+        static_cast<PyObject*(*)(::ns::K*, ::clif::py::PostConv)>(&::ns::Clif_PyObjFrom),
+        static_cast<PyObject*(*)(std::shared_ptr<::ns::K>, ::clif::py::PostConv)>(&::ns::Clif_PyObjFrom),
+        static_cast<PyObject*(*)(std::unique_ptr<::ns::K>, ::clif::py::PostConv)>(&::ns::Clif_PyObjFrom),
+        static_cast<PyObject*(*)(::ns::K&&, ::clif::py::PostConv)>(&::ns::Clif_PyObjFrom),
+        static_cast<int(*)(const ::ns::K &, ::std::string*)>(&::ns::f),
+      };"""), base)
+    header = '\n'.join(m.GenerateHeader('my.clif', 'my.h', []))
+    self.assertIn('#include "clif/python/capi.h"', header)
+    self.assertIn(textwrap.dedent("""\
+      struct CApi {
+        ::clif::capi::TableHeader header;
+        ::ns::K* (*K_ThisPtr)(PyObject*);
+        PyObject* (*K_FromPtr)(::ns::K*, ::clif::py::PostConv);
+        PyObject* (*K_FromShared)(std::shared_ptr<::ns::K>, ::clif::py::PostConv);
+        PyObject* (*K_FromUnique)(std::unique_ptr<::ns::K>, ::clif::py::PostConv);
+        PyObject* (*K_FromMove)(::ns::K&&, ::clif::py::PostConv);
+        int (*f)(const ::ns::K &, ::std::string*);
+
+        static constexpr const char* kCapsuleName = "my.test._C_API";"""),
+                  header)
+    self.assertIn(textwrap.dedent("""\
+      namespace capi {
+
+      inline ::ns::K* K_ThisPtr(PyObject* py) {
+        const CApi* api = ::clif::capi::Get<CApi>();
+        return api ? api->K_ThisPtr(py) : nullptr;
+      }
+
+      }  // namespace capi"""), header)
+    pxd = '\n'.join(m.GeneratePxd('my.clif', 'my/test_clif.h'))
+    self.assertTrue(pxd.endswith(textwrap.dedent("""
+      cdef extern from "my/test_clif.h":
+        cppclass K "::ns::K":
+          pass
+
+      cdef extern from "my/test_clif.h" namespace "my_test_clifwrap::capi":
+        K* K_ThisPtr(object) except NULL""")), pxd)
+
 
 if __name__ == '__main__':
   unittest.main()
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_PYTHON_PROBES_H_
+#define CLIF_PYTHON_PROBES_H_
+
+/*
+USDT (static tracepoint) probes of the "clif" provider for perf, bpftrace and
+other system-level profilers. They are compiled in with -DCLIF_USDT_PROBES
+where <sys/sdt.h> is available and are no-ops otherwise. An unattached probe
+costs a nop instruction.
+
+  call__entry(name), call__return(name)
+      A wrapped function or method is called from Python (only in modules
+      generated with pyclif --probes). |name| is "<Python qualname>: <C++
+      signature>".
+  gil__release(name), gil__acquire(name)
+      Around its C++ call, unless it keeps the GIL.
+  conversion__failure(func, arg, ctype)
+      A Python argument could not be converted to C++.
+  callback__entry(type)
+      C++ calls a Python callable (std::function argument or virtual method
+      override). |type| is the callable's Python type name.
+
+For example, to count calls of every wrapper in mod.so:
+  bpftrace -e 'usdt:./mod.so:clif:call__entry { @[str(arg0)] = count(); }'
+
+The generated wrappers are also exported under their Python qualname, e.g.
+"pkg.mod.Class.method" (a "_" replaces other characters than [A-Za-z0-9_.] and
+is appended to keep the name unique), so that perf report and other sampling
+profilers name them even in stripped builds. Without pyclif --probes they are
+static functions named <module>_clifwrap::py<Class>::wrap<C++ name>.
+*/
+
+#if defined(CLIF_USDT_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define CLIF_HAVE_USDT_PROBES 1
+#endif
+#endif
+
+#ifdef CLIF_HAVE_USDT_PROBES
+#define CLIF_PROBE1(name, a) DTRACE_PROBE1(clif, name, a)
+#define CLIF_PROBE3(name, a, b, c) DTRACE_PROBE3(clif, name, a, b, c)
+#else
+#define CLIF_PROBE1(name, a) ((void)(a))
+#define CLIF_PROBE3(name, a, b, c) ((void)(a), (void)(b), (void)(c))
+#endif
+
+// Sets the symbol name of a generated wrapper on its declaration.
+#if defined(__GNUC__) && defined(__ELF__)
+#define CLIF_WRAPPER_SYMBOL(name) \
+  __asm__(name) __attribute__((visibility("default")))
+#else
+#define CLIF_WRAPPER_SYMBOL(name)
+#endif
+
+namespace clif {
+namespace probes {
+
+// Fires the probes of a generated wrapper, entry and GIL ones from the
+// wrapper, call__return when it goes out of scope.
+class CallScope {
+ public:
+  explicit CallScope(const char* name) : name_(name) {
+    CLIF_PROBE1(call__entry, name_);
+  }
+  ~CallScope() { CLIF_PROBE1(call__return, name_); }
+  CallScope(const CallScope&) = delete;
+  CallScope& operator=(const CallScope&) = delete;
+
+  void GilReleased() const { CLIF_PROBE1(gil__release, name_); }
+  void GilAcquired() const { CLIF_PROBE1(gil__acquire, name_); }
+
+ private:
+  const char* name_;
+};
+
+}  // namespace probes
+}  // namespace clif
+
+#endif  // CLIF_PYTHON_PROBES_H_
@@ -71,6 +71,10 @@ PyMappingMethods = [
     'mp_subscript',
     'mp_ass_subscript',
 ]
+PyBufferProcs = [
+    'bf_getbuffer',
+    'bf_releasebuffer',
+]
 PyTypeObject = [
     'tp_name',
     'tp_basicsize',
@@ -76,7 +76,9 @@ Module can produces 3 output streams:
 #   Clif_PyObjAs(_, A::B*);
 # to convert from Python classes A and A.B to/from C++ A, A::B.
 
+import collections
 import itertools
+import re
 
 from clif.python import ast_manipulations
 from clif.python import astutils
@@ -93,6 +95,20 @@ WRAPPER_CLASS_NAME = 'wrapper'
 STATIC_LINKING_PREFIX = ''  # Disable static linking.
 _ClassNamespace = lambda pyname: 'py' + pyname  # pylint: disable=invalid-name
 _ITER_KW = '__iter__'
+# A class defining any of these does not get slots from its C++ operators.
+_COMPARE_AND_HASH = frozenset(('__eq__', '__ne__', '__lt__', '__le__',
+                               '__gt__', '__ge__', '__hash__'))
+# Data members of final classes of these types use clif/python/fields.h.
+_ARITHMETIC_FIELD_TYPES = frozenset((
+    'bool', 'float', 'int', 'int64', 'long', 'uint', 'uint8', 'uint32',
+    'uint64', 'ulong'))
+# @container_protocol (xx, slot, clif::container function returning it).
+_CONTAINER_SLOTS = (
+    ('sq', 'sq_length', 'SqLength'),
+    ('sq', 'sq_item', 'SqItem'),
+    ('mp', 'mp_subscript', 'MpSubscript'),
+    ('sq', 'sq_contains', 'SqContains'),
+)
 
 
 class Context(object):
@@ -122,7 +138,12 @@ class Module(object):
                full_dotted_modname,
                typemap=(),
                namemap=(),
-               indent=None):
+               indent=None,
+               c_api=False,
+               interop=False,
+               probes=False,
+               lazy_types=False,
+               import_time=False):
     global I
     if indent is None:
       indent = I
@@ -148,6 +169,19 @@ class Module(object):
     self.init = []        # Extra init lines
     self.nested = []      # Stack of nested Context's
     self.catch_cpp_exceptions = False
+    # Export C-API capsule with (name, return type, (params), value) entries.
+    self.c_api = [] if c_api else None
+    # Share wrapped objects with other CLIF backends, see interop.h.
+    self.interop = interop
+    # Fire USDT probes (see probes.h) from the wrapped functions and export
+    # them under their Python qualnames.
+    self.probes = probes
+    self.wrapper_symbols = set()
+    # Build class types on first use instead of at import, see GenLazyTypes.
+    self.lazy_types = lazy_types
+    self.lazy_enums = []  # (dict value, getter) of enums created on first use
+    # Time Ready() and Init() steps for -X importtime, see ImportTimer.
+    self.import_time = import_time
     # common with Context
     self._dict = []       # constants, types, enums as (name, obj)
     self._methods = []
@@ -216,6 +250,13 @@ class Module(object):
       wrapper_name = 'wrap' + types.Mangle(cname)
       if pyname != cname:
         wrapper_name += '_as_' + pyname
+    if (self.c_api is not None and not self.nested and
+        not f.is_extend_method and not f.cpp_opfunction):
+      # Get the exact C++ signature before returns may be dropped below.
+      params = astutils.TupleStr(astutils.FuncExactParamTypes(f))
+      ret = astutils.FuncReturnType(f, true_cpp_type=True)
+      self.c_api.append((pyname, ret, params, 'static_cast<%s(*)%s>(&%s)' % (
+          ret, params, f.name.cpp_name)))
     if f.ignore_return_value:
       assert len(f.returns) < 2, ('Func with ignore_return_value has too many'
                                   ' returns (%d)' % len(f.returns))
@@ -244,7 +285,9 @@ class Module(object):
         prepend_self=self_param,
         catch=self.catch_cpp_exceptions and not f.cpp_noexcept,
         postcall_init=None,
-        typepostconversion=self.typemap):
+        typepostconversion=self.typemap,
+        probe=self._ProbeName(f, pyname) if self.probes else None,
+        symbol=self._WrapperSymbol(pyname) if self.probes else None):
       yield s
     if f.classmethod:
       meth += ' | METH_CLASS'
@@ -252,6 +295,26 @@ class Module(object):
     self.methods.append((f.name.native.rstrip('@'), wrapper_name, meth,
                          '\\n'.join(astutils.Docstring(f)).replace('"', '\\"')))
 
+  def _QualName(self, pyname):
+    """Python qualname of pyname in the current scope."""
+    return '.'.join([self.path] + [n.pyname for n in self.nested] + [pyname])
+
+  def _ProbeName(self, f, pyname):
+    """Wrapper name in probes: Python qualname and C++ signature."""
+    qualname = self._QualName(pyname)
+    signature = '%s %s%s' % (astutils.FuncReturnType(f),
+                             f.name.cpp_name or f.name.native,
+                             astutils.FuncParamStr(f))
+    return ('%s: %s' % (qualname, signature)).replace('"', r'\"')
+
+  def _WrapperSymbol(self, pyname):
+    """Unique exported wrapper symbol: Python qualname, [A-Za-z0-9_.] only."""
+    symbol = re.sub(r'[^A-Za-z0-9_.]', '_', self._QualName(pyname))
+    while symbol in self.wrapper_symbols:
+      symbol += '_'
+    self.wrapper_symbols.add(symbol)
+    return symbol
+
   def _FunctionCallExpr(self, f, cname, pyname):
     """Find function call/postcall C++ expression."""
     call = f.name.cpp_name
@@ -423,6 +486,24 @@ class Module(object):
           # For a nested container we'll try to return it (we use
           # cpp_toptr_conversion as an indicator for a custom container).
           getval = '::clif::MakeStdShared(%s, &%s)' % (_GetCppObj(), cvar)
+    if v.view:
+      if v.type.cpp_raw_pointer or ctype.startswith(
+          ('::std::unique_ptr', '::std::shared_ptr')):
+        raise TypeError('@view var %s must be a container, not %s' %
+                        (v.name.native, ctype))
+      # A view aliasing the container member instead of a converted copy.
+      getval = '::clif::view::Of(::clif::MakeStdShared(%s, &%s))' % (
+          _GetCppObj(), cvar)
+    if (self.final and not is_property and not unproperty and
+        not v.is_extend_variable and not v.type.cpp_raw_pointer and
+        v.type.lang_type in _ARITHMETIC_FIELD_TYPES):
+      # No ThisPtr and inline conversions for a plain arithmetic field.
+      for s in gen.FieldGetter(getter, _GetCppObj(), vname):
+        yield s
+      for s in gen.FieldSetter(setter, _GetCppObj(), vname, v,
+                               as_str='PyUnicode_AsUTF8'):
+        yield s
+      return
     for s in gen.VarGetter(getter, unproperty, base, getval,
                            postconv.Initializer(v.type, self.typemap),
                            is_extend=v.is_extend_variable):
@@ -436,7 +517,8 @@ class Module(object):
           v,
           setval,
           as_str='PyUnicode_AsUTF8',
-          is_extend=v.is_extend_variable):
+          is_extend=v.is_extend_variable,
+          view=v.view):
         yield s
 
   def WrapClass(self, c, unused_ln, cpp_namespace, unused_class_ns=''):
@@ -447,6 +529,9 @@ class Module(object):
     ns = self.class_namespace
     yield ''
     yield 'namespace %s {' % ns
+    if self.lazy_types and len(self.nested) == 1:
+      yield ''
+      yield 'static bool ReadyType();  // Builds this class on first use.'
     virtual, has_iterator = _IsSpecialClass(c, pyname)
     if virtual:
       for s in gen.VirtualOverriderClass(
@@ -539,15 +624,52 @@ class Module(object):
             for s in gen.CastAsCapsule(_GetCppObj(), p, w):
               yield s
             self.methods.append((w, w, NOARGS, 'Upcast to %s*' % p))
-      _AppendReduceExIfNeeded(self.methods)
-      if self.methods:
-        for s in slots.GenSlots(self.methods, tp_slots,
-                                tracked_groups=tracked_slot_groups):
+      if self.interop:
+        w = 'clif_shared_ptr'
+        for s in gen.ClifSharedPtr(_GetCppObj(), c.name.cpp_name, virtual, w):
           yield s
-        if self.methods:  # If all methods are slots, it's empty.
-          for s in gen.MethodDef(self.methods):
-            yield s
-          tp_slots['tp_methods'] = gen.MethodDef.name
+        self.methods.append(('__clif_shared_ptr__', w, NOARGS,
+                             'Share the C++ object with other CLIF backends'))
+      value_slots = (c.cpp_has_eq and c.cpp_hasher and
+                     not any(m[0] in _COMPARE_AND_HASH for m in self.methods))
+      if c.final and (value_slots or c.container_protocol or
+                      c.HasField('buffer')):
+        yield ''
+        yield 'static %s* ThisPtr(PyObject*);' % c.name.cpp_name
+      if value_slots:
+        # Native slots for a C++ value type, unless .clif defines any of them.
+        for s in gen.CppHash(c.name.cpp_name, c.cpp_hasher):
+          yield s
+        tp_slots['tp_hash'] = gen.CppHash.name
+        for s in gen.CppRichCompare(c.name.cpp_name,
+                                    WRAPPER_CLASS_NAME + '_Type', c.cpp_has_lt):
+          yield s
+        tp_slots['tp_richcompare'] = gen.CppRichCompare.name
+      if c.HasField('buffer'):
+        for s in gen.BufferProcs(c.name.cpp_name, _GetCppObj(), c.buffer):
+          yield s
+        tracked_slot_groups['bf'] = {
+            'bf_getbuffer': gen.BufferProcs.name,
+            'bf_releasebuffer': '::clif::buffer::Release'}
+      _AppendReduceExIfNeeded(self.methods)
+      for s in slots.GenSlots(self.methods, tp_slots,
+                              tracked_groups=tracked_slot_groups):
+        yield s
+      if c.container_protocol:
+        for xx, slot, func in _CONTAINER_SLOTS:
+          xx_slots = tracked_slot_groups.setdefault(xx, {})
+          if slot not in xx_slots:  # Not defined in .clif.
+            xx_slots[slot] = '::clif::container::%s<%s, ThisPtr>()' % (
+                func, c.name.cpp_name)
+      # Not a user-definable slot, added after GenSlots rejected it.
+      w = 'clif_sizeof'
+      for s in gen.SizeOf(_GetCppObj(), w):
+        yield s
+      self.methods.append(('__sizeof__', w, NOARGS,
+                           'Size of the wrapper and the C++ object it owns'))
+      for s in gen.MethodDef(self.methods):
+        yield s
+      tp_slots['tp_methods'] = gen.MethodDef.name
     qualname = '.'.join(f.pyname for f in self.nested)
     tp_slots['tp_name'] = '"%s.%s"' % (self.path, qualname)
     if c.docstring:
@@ -580,7 +702,8 @@ class Module(object):
       yield s
     if not iter_class:
       for s in types.GenThisPointerFunc(c.name.cpp_name, WRAPPER_CLASS_NAME,
-                                        c.final):
+                                        c.final, self.interop,
+                                        self.lazy_types):
         yield s
     yield ''
     yield '}  // namespace ' + ns
@@ -606,7 +729,8 @@ class Module(object):
                           can_move=c.cpp_movable and not c.cpp_abstract,
                           can_destruct=c.cpp_has_public_dtor,
                           virtual=vclass if virtual else '',
-                          ns=cpp_namespace))
+                          ns=cpp_namespace, interop=self.interop,
+                          lazy=self.lazy_types))
 
   def WrapEnum(self, e, unused_ln, cpp_namespace, unused_class_ns=''):
     """Process AST.EnumDecl e."""
@@ -628,12 +752,18 @@ class Module(object):
     genw = 'wrap'+Ident(e.name.cpp_name)
     pyname = '.'.join([f.pyname for f in self.nested] + [e.name.native])
     t = types.EnumType(e.name.cpp_name, pyname, pytype, self.CppName(wclass),
-                       cpp_namespace)
+                       cpp_namespace, lazy=self.lazy_types)
     self.types.append(t)
-    self.dict.append((e.name.native,
-                      '(%s=%s())' % (self.CppName(wclass), self.CppName(genw))))
+    if self.lazy_types:
+      self.dict.append((e.name.native, t.getter + '()'))
+      self.lazy_enums.append((t.getter + '()', t.getter))
+    else:
+      self.dict.append((e.name.native, '(%s=%s())' % (self.CppName(wclass),
+                                                      self.CppName(genw))))
     if not self.enums:
       self.enums = True
+      if self.import_time:
+        self.init.append(gen.ImportTimeStep('import enum'))
       self.init.extend([
           '{PyObject* em = PyImport_ImportModule("enum");',
           ' if (em == nullptr) goto err;',
@@ -654,13 +784,55 @@ class Module(object):
     self.types.append(types.CapsuleType(p.name.cpp_name, p.name.native, ns))
     return []
 
+  def GenLazyTypes(self):
+    """Generate classes and enums built on first use, module __getattr__.
+
+    Consumes self.types_init, so Ready() builds no types.
+
+    Yields:
+      ReadyType() per top-level class and module __getattr__/__dir__ source
+    """
+    assert not self.nested, 'Stack was not fully processed'
+    lazy = {o: g for o, g in self.lazy_enums}
+    units = collections.OrderedDict()  # ns: (types_init, base_ns, dict)
+    for t in self.types_init:
+      cppname, _, wrapped_base, dict_ = t
+      ns = cppname.split('::', 1)[0]
+      types_init, base_ns, type_dict = units.setdefault(ns, ([], [], []))
+      types_init.append(t)
+      if wrapped_base:
+        b = wrapped_base.split('::', 1)[0]
+        if b != ns and b not in base_ns:
+          base_ns.append(b)
+      type_dict.extend((cppname, n, o, o in lazy) for n, o in dict_)
+    _CheckNoBaseCycles(units)
+    lazy.update((types.AsPyObj(ns+'::wrapper_Type'), ns+'::GetType')
+                for ns in units)
+    lazy_names = [(n, lazy[o]) for n, o in self.dict if o in lazy]
+    if not lazy_names: return
+    self.dict[:] = [(n, o) for n, o in self.dict if o not in lazy]
+    prebuilt = {t[0] for t in self.types_init}
+    self.types_init = []
+    for s in gen.LazyTypes(
+        [(ns,) + u for ns, u in units.items()], lazy_names, prebuilt,
+        self.import_time):
+      yield s
+    self.methods.append(('__getattr__', 'LazyGetAttr', 'METH_O',
+                         '__getattr__(name)  Builds a wrapped class or enum'))
+    self.methods.append(('__dir__', 'LazyDir', NOARGS,
+                         '__dir__()  Module names including unbuilt types'))
+
   def GenTypesReady(self):
     """Generate Ready() function to call PyType_Ready for wrapped types."""
     assert not self.nested, 'Stack was not fully processed'
     for cppname, _, _, dict_ in self.types_init:
-      self.init.extend('if (PyDict_SetItemString(%s->tp_dict, "%s", %s) < 0)'
-                       ' goto err;' % (cppname, n, o) for n, o in dict_)
-    for s in gen.ReadyFunction(self.types_init):
+      for n, o in dict_:
+        if self.import_time:
+          self.init.append(gen.ImportTimeStep(
+              '%s.%s' % (gen.PyNameOfType(cppname), n)))
+        self.init.append('if (PyDict_SetItemString(%s->tp_dict, "%s", %s) < 0)'
+                         ' goto err;' % (cppname, n, o))
+    for s in gen.ReadyFunction(self.types_init, self.import_time):
       yield s
 
   def GenInitFunction(self, api_source_h):
@@ -668,13 +840,28 @@ class Module(object):
     assert not self.nested, 'Stack was not fully processed'
     for s in gen.InitFunction('CLIF-generated module for %s' % api_source_h,
                               gen.MethodDef.name if self.methods else 'nullptr',
-                              self.init, self.dict):
+                              self.init, self.dict, self.import_time):
       yield s
 
   def GenerateBase(self, ast, more_headers):
     """Extension module generation."""
     ast_manipulations.MoveExtendsBackIntoClassesInPlace(ast)
+    if self.import_time and ast.extra_init:
+      self.init.append(gen.ImportTimeStep('init statements'))
     self.init += ast.extra_init
+    if self.interop:
+      more_headers = ['clif/python/interop.h'] + more_headers
+    if astutils.AnyClass(ast.decls, lambda c: c.cpp_hasher == '::absl::Hash'):
+      more_headers = ['absl/hash/hash.h'] + more_headers
+    if astutils.AnyClass(ast.decls, lambda c: c.final):
+      more_headers = ['clif/python/fields.h'] + more_headers
+    if astutils.AnyClass(ast.decls, lambda c: c.HasField('buffer')):
+      more_headers = ['clif/python/buffer.h'] + more_headers
+    container_h = (['clif/python/container.h'] if astutils.AnyClass(
+        ast.decls, lambda c: c.container_protocol) else [])
+    if astutils.AnyClass(ast.decls, lambda c: any(
+        m.decltype == m.VAR and m.var.view for m in c.members)):
+      container_h.append('clif/python/member_view.h')
     for s in gen.Headlines(
         ast.source,
         [
@@ -685,7 +872,7 @@ class Module(object):
         [
             'clif/python/stltypes.h',
             'clif/python/slots.h'
-        ],
+        ] + container_h,
         open_ns=self.wrap_namespace):
       yield s
     yield ''
@@ -704,11 +891,18 @@ class Module(object):
     assert not self.nested, 'decl stack not exhausted (in GenBase)'
     yield ''
     yield '// Initialize module'
+    if self.lazy_types:
+      for s in self.GenLazyTypes():  # consumes self.types_init
+        yield s
     if self.methods:
       for s in gen.MethodDef(self.methods):
         yield s
     for s in self.GenTypesReady():  # extends self.init
       yield s
+    if self.c_api is not None:
+      yield ''
+      yield 'PyObject* CApiCapsule();'
+      self.dict.append(('_C_API', 'CApiCapsule()'))
     for s in self.GenInitFunction(ast.source):  # consumes self.init
       yield s
     yield ''
@@ -722,6 +916,17 @@ class Module(object):
       for ns, ts in itertools.groupby(self.types, types.Namespace):
         for s in gen.TypeConverters(ns, ts, self.wrap_namespace):
           yield s
+    if self.c_api is not None:
+      class_entries = []
+      for t in self._ClassTypes():
+        class_entries.extend(t.CApiEntries())
+      self.c_api[:0] = class_entries
+      yield ''
+      yield gen.OpenNs(self.wrap_namespace)
+      for s in gen.CApiCapsule(self.c_api):
+        yield s
+      yield ''
+      yield gen.CloseNs(self.wrap_namespace)
     if self.static_init:
       for s in gen.PyModInitFunction(
           init_name=self.static_init,
@@ -749,6 +954,8 @@ class Module(object):
     """Generate header file with type conversion declarations."""
     if more_headers is None:
       more_headers = []
+    if self.c_api is not None:
+      more_headers = ['clif/python/capi.h'] + more_headers
     for s in gen.Headlines(source_filename, [
         'absl/types/optional.h', api_header_filename,
         'clif/python/postconv.h'
@@ -772,11 +979,51 @@ class Module(object):
       yield '// CLIF init_module else goto err;'
     else:
       yield '// This module defines no types.'
+    if self.c_api is not None:
+      yield ''
+      yield gen.OpenNs(self.wrap_namespace)
+      for s in gen.CApiStruct(self.path + '._C_API', self.c_api):
+        yield s
+      for s in gen.CApiThisPtr((t.capi_name, t.cname)
+                               for t in self._ClassTypes()):
+        yield s
+      yield ''
+      yield gen.CloseNs(self.wrap_namespace)
     for m in macros:
       yield ''
       yield '// CLIF macro %s %s' % (
           m.name, m.definition.decode('utf-8').replace('\n', r'\n'))
 
+  def GeneratePxd(self, source_filename, header_include):
+    """Generate Cython declarations of the C-API ThisPtr helpers."""
+    assert self.c_api is not None, 'Cython .pxd needs the C-API capsule'
+    yield '# This file was automatically generated by PyCLIF.'
+    yield '# Version %s' % gen.VERSION
+    yield '# source: %s' % source_filename
+    yield '#'
+    yield '# Get C++ pointers from %s objects in Cython:' % self.path
+    yield '#   from %s cimport Foo, Foo_ThisPtr' % self.path
+    yield '#   cdef Foo* foo = Foo_ThisPtr(obj)  # TypeError if not a Foo.'
+    yield '# Cast the pointer to a fuller cppclass declaration to call methods.'
+    classes = list(self._ClassTypes())
+    if not classes:
+      yield ''
+      yield '# This module defines no classes.'
+      return
+    yield ''
+    yield 'cdef extern from "%s":' % header_include
+    for t in classes:
+      yield I+'cppclass %s "%s":' % (t.capi_name, t.cname)
+      yield I+I+'pass'
+    yield ''
+    yield 'cdef extern from "%s" namespace "%s::capi":' % (
+        header_include, self.wrap_namespace)
+    for t in classes:
+      yield I+'%s* %s_ThisPtr(object) except NULL' % ((t.capi_name,)*2)
+
+  def _ClassTypes(self):
+    return (t for t in self.types if isinstance(t, types.ClassType))
+
 
 def _ProcessInheritance(bases, wrapped_type, namemap):
   """Get base class."""
@@ -810,6 +1057,18 @@ def _ProcessInheritance(bases, wrapped_type, namemap):
   return base, wrapped_base
 
 
+def _CheckNoBaseCycles(units):
+  """Raise if lazily built classes derive from each other's nested classes."""
+  def Visit(ns, path):
+    if ns in path:
+      raise ValueError('--lazy_types can\'t build classes deriving from each'
+                       ' other\'s nested classes: %s' % ' -> '.join(path+[ns]))
+    for b in units[ns][1]:
+      Visit(b, path+[ns])
+  for ns in units:
+    Visit(ns, [])
+
+
 def _WrapIterSubclass(members, typemap):
   """Special-case nested __iter__ class."""
   assert len(members) == 1, ('__iter__ class must have only one "def",'
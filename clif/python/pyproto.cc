@@ -22,6 +22,7 @@ headers are included.
 #include <string>
 
 #include "clif/python/pyproto.h"
+#include "clif/python/conversion_profile.h"
 #include "clif/python/runtime.h"
 #include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/descriptor.h"
@@ -217,12 +218,14 @@ PyObject* PyProtoFrom(const ::proto2::Message* cproto,
                       PyObject* imported_pyproto_class,
                       const char* element_name) {
   DCHECK(cproto != nullptr);
+  profile::ConversionTimer timer(typeid(*cproto), profile::Direction::kToPy);
   if (imported_pyproto_class == nullptr) return nullptr;  // Import failed.
   if (!SetNestedName(&imported_pyproto_class, element_name)) return nullptr;
   PyObject* pb = PyObject_CallObject(imported_pyproto_class, nullptr);
   Py_DECREF(imported_pyproto_class);
   if (pb == nullptr) return nullptr;
   std::string bytes = cproto->SerializePartialAsString();
+  timer.AddItems(bytes.size());
   PyObject* merge = PyUnicode_FromString("MergeFromString");
   PyObject* cpb = PyMemoryView_FromMemory(const_cast<char*>(bytes.data()),
                                           bytes.size(), PyBUF_READ);
@@ -112,6 +112,8 @@ class Postprocessor(object):
     self._include_paths = include_paths
     self._preamble = preamble
     self.source = None
+    # Paths of all CLIF headers read by _include, for build depfiles.
+    self.dependencies = []
     # _macro_values [actual, param, values] only set in _class that
     # has implements MACRO<actual, param, values>.
     self._macro_values = []
@@ -377,13 +379,14 @@ class Postprocessor(object):
     # Scan hdr for new types
     namespace = p[1]+'.' if len(p) > 1 else ''
     for root in self._include_paths:
+      path = os.path.join(root, hdr)
       try:
-        with codecs.open(os.path.join(root, hdr),
-                         encoding='utf-8') as include_file:
+        with codecs.open(path, encoding='utf-8') as include_file:
           pb.usertype_includes.extend(
               _read_include(include_file, hdr, namespace,
                             self._typetable, self._capsules, self._macros,
                             pb.extra_init))
+        self.dependencies.append(path)
         break
       except IOError:
         pass
@@ -485,6 +488,12 @@ class Postprocessor(object):
       if 'suppress_upcasts' in decorators:
         p.suppress_upcasts = True
         decorators.remove('suppress_upcasts')
+      if 'opaque_container' in decorators:
+        p.opaque_container = True
+        decorators.remove('opaque_container')
+      if 'container_protocol' in decorators:
+        p.container_protocol = True
+        decorators.remove('container_protocol')
     if decorators:
       raise NameError('Unknown class decorator(s)%s: %s'
                       % (atln, ', '.join(decorators)))
@@ -513,6 +522,11 @@ class Postprocessor(object):
           raise SyntaxError('__iter__ class must only def __next__ at line %d'
                             % line_number)
       else:
+        if decl[0] == 'buffer':
+          if p.HasField('buffer'):
+            raise SyntaxError('buffer must be declared once' + atln)
+          _set_buffer(p.buffer, decl[2:], atln)
+          continue
         if decl[0] == 'implements':
           name = decl[2]
           self._macro_values = [pyname] + decl[3:]
@@ -707,6 +721,12 @@ class Postprocessor(object):
     if 'extend' in decorators:
       p.is_extend_variable = True
       decorators.remove('extend')
+    if 'view' in decorators:
+      if ast.getter or p.is_extend_variable:
+        raise SyntaxError('@view var %s must be a C++ data member at line %d'
+                          % (p.name.native, ln))
+      p.view = True
+      decorators.remove('view')
     return p.name.native
 
   def _const(self, ln, ast, pb, ns=None):
@@ -1397,6 +1417,23 @@ def _set_keep_gil(f, val):
   f.py_keep_gil = val
 
 
+# Names of the buffer statement accessors (AST.BufferDecl fields).
+_BUFFER_ACCESSORS = ('data', 'shape', 'strides', 'format')
+
+
+def _set_buffer(pb, accessors, atln):
+  """Set BufferDecl pb from the buffer statement name=`accessor` pairs."""
+  for name, cpp_name in accessors:
+    if name not in _BUFFER_ACCESSORS:
+      raise NameError('buffer accessor must be one of %s, not %s%s'
+                      % ('/'.join(_BUFFER_ACCESSORS), name, atln))
+    if getattr(pb, name):
+      raise NameError('buffer %s accessor repeated%s' % (name, atln))
+    setattr(pb, name, cpp_name)
+  if not pb.data:
+    raise NameError('buffer needs a data accessor' + atln)
+
+
 def _add_uniq(class_name, names_set, new_name):
   assert new_name, class_name+' has %s' % names_set
   if new_name:
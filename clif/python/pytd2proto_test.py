@@ -81,6 +81,16 @@ class ToprotoTest(unittest.TestCase):
     pytd_parser.reset_indentation()
     self.maxDiff = 100000  # pylint: disable=invalid-name
 
+  def testDependenciesListIncludedHeaders(self):
+    with open(TMP_FILE, 'w') as pytd_file:
+      pytd_file.write('from "clif/python/types.h" import *\n')
+    p = pytd2proto.Postprocessor(include_paths=[os.environ['CLIF_DIR']])
+    with open(TMP_FILE, 'r') as pytd_file:
+      p.Translate(pytd_file)
+    self.assertEqual(
+        p.dependencies,
+        [os.path.join(os.environ['CLIF_DIR'], 'clif/python/types.h')])
+
   def testParsingNonzeroRaisesNameError(self):
     with self.assertRaises(NameError):
       self.ClifEqualWithTypes("""\
@@ -1099,6 +1109,92 @@ class ToprotoTest(unittest.TestCase):
             pass
         """, '')
 
+  def testFromClassBuffer(self):
+    self.ClifEqual("""\
+      from "foo.h":
+        class Tile:
+          buffer(data=`pixels`, shape=`dims`)
+      """, """\
+        source: "clif_python_pytd2proto_test"
+        decls {
+          decltype: CLASS
+          cpp_file: "foo.h"
+          line_number: 2
+          class_ {
+            name {
+              native: "Tile"
+              cpp_name: "Tile"
+            }
+            buffer {
+              data: "pixels"
+              shape: "dims"
+            }
+          }
+        }
+      """)
+
+  def testFromClassBufferErrors(self):
+    for body in ('buffer(shape=`dims`)',
+                 'buffer(data=`pixels`, size=`size`)',
+                 'buffer(data=`pixels`, data=`bytes`)'):
+      pytd_parser.reset_indentation()
+      with self.assertRaises(NameError):
+        self.ClifEqual("""\
+          from "foo.h":
+            class Tile:
+              %s
+          """ % body, '')
+
+  def testFromClassViewVar(self):
+    self.ClifEqualWithTypes("""\
+      from "foo.h":
+        class Holder:
+          @view
+          values: list<int>
+      """, """\
+        source: "clif_python_pytd2proto_test"
+        usertype_includes: "clif/python/types.h"
+        decls {
+          decltype: CLASS
+          cpp_file: "foo.h"
+          line_number: 2
+          class_ {
+            name {
+              native: "Holder"
+              cpp_name: "Holder"
+            }
+            members {
+              decltype: VAR
+              line_number: 3
+              var {
+                name {
+                  native: "values"
+                  cpp_name: "values"
+                }
+                type {
+                  lang_type: "list<int>"
+                  cpp_type: "std::vector"
+                  params {
+                    lang_type: "int"
+                    cpp_type: "int"
+                  }
+                }
+                view: true
+              }
+            }
+          }
+        }
+      """)
+
+  def testFromClassViewProperty(self):
+    with self.assertRaises(SyntaxError):
+      self.ClifEqualWithTypes("""\
+        from "foo.h":
+          class Holder:
+            @view
+            values: list<int> = property(`values`)
+        """, '')
+
   def testFromRenamedClassTemplate(self):
     self.ClifEqual(
         """\
@@ -1141,6 +1237,29 @@ class ToprotoTest(unittest.TestCase):
         }
       """)
 
+  def testFromOpaqueContainerClass(self):
+    self.ClifEqual(
+        """\
+      from "foo.h":
+        @opaque_container
+        class `Vector<int>` as Ints:
+          pass
+      """, """\
+        source: "clif_python_pytd2proto_test"
+        decls {
+          decltype: CLASS
+          cpp_file: "foo.h"
+          line_number: 2
+          class_ {
+            name {
+              native: "Ints"
+              cpp_name: "Vector<int>"
+            }
+            opaque_container: true
+          }
+        }
+      """)
+
   def testFromClassEnumErrShortName(self):
     with self.assertRaises(NameError):
       self.ClifEqual("""\
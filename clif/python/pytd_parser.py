@@ -141,6 +141,8 @@ interface_stmt = G(K('interface') - interface_composed_type) - BLOCK(methoddef
                                                                      | vardef)
 implements_composed_type = NAME - ANGLED(pp.delimitedList(dotted_name))
 implementsdef = G(K('implements') - implements_composed_type)
+bufferdef = G(K('buffer') + PARENS(pp.delimitedList(
+    Group(NAME + S('=') - ASTRING))))
 
 nested_decl = pp.Forward()
 classdef = G(
@@ -155,7 +157,8 @@ stmeth_stmt = G(K('staticmethods') - S('from') + ASTRING - BLOCK(funcdef))
 _decl = classdef | enumdef | constdef
 global_decl = (
     K('pass') | funcdef | capsule_def | _decl | interface_stmt | stmeth_stmt)
-nested_decl <<= vardef | methoddef | _decl | K('pass') | implementsdef
+nested_decl <<= (vardef | methoddef | _decl | K('pass') | implementsdef |
+                 bufferdef)
 
 import_stmt = G(S('from') + pp.WordEnd() + dotted_name - K('import') + NAME)
 # Put 'import' first.
@@ -219,6 +219,14 @@ class PytdParserTest(absltest.TestCase):
         'class', 0, [], ['Abc'], [],
         [['implements', 13, 'f', 'dotted.x', 'dotted.y']]
     ])
+    reset_indentation()
+    self.EQ(classdef, 'class Abc:\n  buffer(data=`d`, shape=`dims`)',
+            ['class', 0, [], ['Abc'], [],
+             [['buffer', 13, ['data', 'd'], ['shape', 'dims']]]])
+    reset_indentation()
+    self.EQ(classdef, 'class Abc:\n  buffer: int',
+            ['class', 0, [], ['Abc'], [],
+             [['var', 13, [], ['buffer'], [['int']]]]])
 
   def testClassDecorators(self):
     self.EQ(classdef, '@shared\nclass Abc:\n  def f(self)',
@@ -13,6 +13,19 @@
 // limitations under the License.
 
 #include "clif/python/runtime.h"
+#if PY_VERSION_HEX < 0x03090000
+#include <frameobject.h>  // PyFrameObject fields.
+#endif
+#include <algorithm>
+#include <chrono>  // NOLINT: build/c++11
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+#include "clif/python/probes.h"
 // This should be removed once CLIF depends on Abseil.
 #include <cassert>
 // NOLINTNEXTLINE(whitespace/line_length) because of MOE, result is within 80.
@@ -202,6 +215,7 @@ PyObject* ArgError(const char func[],
                    const char* argname,
                    const char ctype[],
                    PyObject* arg) {
+  CLIF_PROBE3(conversion__failure, func, argname, ctype);
   PyObject* exc = PyErr_Occurred();
   if (exc == nullptr) {
     PyErr_Format(
@@ -426,4 +440,274 @@ cleanup_and_exit:
   return reduced;
 }
 
+void* ProcessWideObject(const char* name, void* (*create)()) {
+  PyObject* capsule = PySys_GetObject(name);  // Borrowed.
+  if (capsule != nullptr && PyCapsule_IsValid(capsule, name)) {
+    return PyCapsule_GetPointer(capsule, name);
+  }
+  // Never deleted: it may be used during interpreter finalization.
+  void* object = create();
+  capsule = PyCapsule_New(object, name, nullptr);
+  if (capsule == nullptr || PySys_SetObject(name, capsule) < 0) {
+    PyErr_Clear();  // Not shared, still usable by this extension.
+  }
+  Py_XDECREF(capsule);
+  return object;
+}
+
+namespace {
+
+// Bump the version if InstanceCounter or InstanceCounters layout changes.
+constexpr char kInstanceCountersName[] = "__clif_instance_counters_v1__";
+
+using InstanceCounters =
+    std::vector<std::pair<std::string, const InstanceCounter*>>;
+
+InstanceCounters* GetInstanceCounters() {
+  static InstanceCounters* counters = static_cast<InstanceCounters*>(
+      ProcessWideObject(kInstanceCountersName,
+                        [] { return static_cast<void*>(new InstanceCounters); }));
+  return counters;
+}
+
+}  // namespace
+
+void RegisterInstanceCounter(const char* py_type, InstanceCounter* counter) {
+  GetInstanceCounters()->emplace_back(py_type, counter);
+}
+
+std::vector<InstanceStats> GetInstanceStats() {
+  const InstanceCounters& counters = *GetInstanceCounters();
+  std::vector<InstanceStats> stats;
+  stats.reserve(counters.size());
+  for (const auto& it : counters) {
+    const InstanceCounter& c = *it.second;
+    stats.push_back({it.first, c.cpp_type,
+                     static_cast<long long>(c.cpp_size),  // NOLINT: runtime/int
+                     c.live.load(std::memory_order_relaxed),
+                     c.total.load(std::memory_order_relaxed)});
+  }
+  std::stable_sort(stats.begin(), stats.end(),
+                   [](const InstanceStats& a, const InstanceStats& b) {
+                     return a.live > b.live;
+                   });
+  return stats;
+}
+
+namespace python {
+
+std::string Demangle(const char* mangled) {
+#if defined(__GNUG__)
+  int status = 0;
+  std::unique_ptr<char, void (*)(void*)> demangled(
+      abi::__cxa_demangle(mangled, nullptr, nullptr, &status), std::free);
+  if (status == 0 && demangled) return demangled.get();
+#endif
+  return mangled;
+}
+
+}  // namespace python
+
+namespace {
+
+// Bump the version if AllocationTracing layout changes.
+constexpr char kAllocationTracingName[] = "__clif_allocation_tracing_v1__";
+// Tracemalloc domains of wrapped C++ types start at 'CL'.
+constexpr unsigned int kFirstTracingDomain = 0x434C0000;
+
+struct AllocationTracing {
+  std::atomic<bool> enabled{false};
+  // Tracemalloc domain of each C++ type (by mangled name), guarded by the GIL.
+  std::map<std::string, unsigned int> domains;
+};
+
+AllocationTracing* GetAllocationTracing() {
+  static AllocationTracing* tracing = static_cast<AllocationTracing*>(
+      ProcessWideObject(kAllocationTracingName, [] {
+        return static_cast<void*>(new AllocationTracing);
+      }));
+  return tracing;
+}
+
+#if defined(__GNUC__) && defined(__USER_LABEL_PREFIX__)
+// Older Python headers declare these without extern "C". The symbol names
+// carry the C label prefix (e.g. "_" on Mach-O).
+#define CLIF_LABEL_STR(x) #x
+#define CLIF_C_LABEL(prefix, name) CLIF_LABEL_STR(prefix) name
+extern "C" int TraceMallocTrack(unsigned int domain, uintptr_t ptr,
+                                size_t size)
+    __asm__(CLIF_C_LABEL(__USER_LABEL_PREFIX__, "PyTraceMalloc_Track"));
+extern "C" int TraceMallocUntrack(unsigned int domain, uintptr_t ptr)
+    __asm__(CLIF_C_LABEL(__USER_LABEL_PREFIX__, "PyTraceMalloc_Untrack"));
+#undef CLIF_C_LABEL
+#undef CLIF_LABEL_STR
+#else
+#define TraceMallocTrack PyTraceMalloc_Track
+#define TraceMallocUntrack PyTraceMalloc_Untrack
+#endif
+
+// Set on first use (with the GIL): owned objects may be created or deleted on
+// threads without the GIL.
+std::atomic<const std::atomic<bool>*> tracing_enabled{nullptr};
+
+bool TracingEnabled() {
+  const std::atomic<bool>* enabled =
+      tracing_enabled.load(std::memory_order_acquire);
+  if (enabled == nullptr) {
+    if (!Py_IsInitialized()) return false;
+    PyGILState_STATE state = PyGILState_Ensure();
+    enabled = &GetAllocationTracing()->enabled;
+    PyGILState_Release(state);
+    tracing_enabled.store(enabled, std::memory_order_release);
+  }
+  return enabled->load(std::memory_order_relaxed) && Py_IsInitialized();
+}
+
+unsigned int TracingDomain(const std::type_info& type) {
+  auto& domains = GetAllocationTracing()->domains;
+  auto it = domains.emplace(type.name(), kFirstTracingDomain + domains.size());
+  return it.first->second;
+}
+
+void TraceOwned(const void* obj, std::size_t size,
+                const std::type_info& type) {
+  PyGILState_STATE state = PyGILState_Ensure();
+  TraceMallocTrack(TracingDomain(type), reinterpret_cast<uintptr_t>(obj),
+                   size);
+  PyGILState_Release(state);
+}
+
+void TraceReleased(const void* obj, const std::type_info& type) {
+  PyGILState_STATE state = PyGILState_Ensure();
+  TraceMallocUntrack(TracingDomain(type), reinterpret_cast<uintptr_t>(obj));
+  PyGILState_Release(state);
+}
+
+constexpr OwnershipObserver kTracingObserver = {TracingEnabled, TraceOwned,
+                                                TraceReleased};
+
+// Installed in every copy of the runtime (extensions may link it statically),
+// so that EnableAllocationTracing() from any extension applies to all.
+const bool tracing_observer_installed = [] {
+  ownership_observer.store(&kTracingObserver, std::memory_order_release);
+  return true;
+}();
+
+}  // namespace
+
+void EnableAllocationTracing(bool on) {
+  GetAllocationTracing()->enabled.store(on, std::memory_order_relaxed);
+}
+
+bool IsAllocationTracingEnabled() { return TracingEnabled(); }
+
+std::map<int, std::string> AllocationTracingDomains() {
+  std::map<int, std::string> types;
+  for (const auto& it : GetAllocationTracing()->domains) {
+    types[it.second] = python::Demangle(it.first.c_str());
+  }
+  return types;
+}
+
+namespace {
+
+// Bump the version if ImportTimer::Span layout changes.
+constexpr char kImportTimerName[] = "__clif_import_timer_v1__";
+
+bool ImportTimeEnabled() {
+  static const bool enabled = [] {
+    PyObject* xoptions = PySys_GetXOptions();  // Borrowed.
+    if (xoptions != nullptr &&
+        PyDict_GetItemString(xoptions, "importtime") != nullptr) {
+      return true;
+    }
+    const char* env = std::getenv("PYTHONPROFILEIMPORTTIME");
+    return env != nullptr && *env != '\0';
+  }();
+  return enabled;
+}
+
+// Python's own -X importtime nesting level, the number of modules being
+// imported. Each of them runs importlib._bootstrap._find_and_load.
+int PythonImportLevel() {
+  int level = 0;
+  PyFrameObject* frame = PyEval_GetFrame();  // Borrowed.
+#if PY_VERSION_HEX >= 0x03090000
+  Py_XINCREF(frame);
+  while (frame != nullptr) {
+    PyCodeObject* code = PyFrame_GetCode(frame);
+    if (PyUnicode_CompareWithASCIIString(code->co_name, "_find_and_load") ==
+        0) {
+      ++level;
+    }
+    Py_DECREF(code);
+    PyFrameObject* back = PyFrame_GetBack(frame);
+    Py_DECREF(frame);
+    frame = back;
+  }
+#else
+  for (; frame != nullptr; frame = frame->f_back) {
+    if (PyUnicode_CompareWithASCIIString(frame->f_code->co_name,
+                                         "_find_and_load") == 0) {
+      ++level;
+    }
+  }
+#endif
+  return level;
+}
+
+long long NowMicros() {  // NOLINT: runtime/int
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+ImportTimer::ImportTimer(const char* module, const char* name)
+    : module_(module) {
+  if (!ImportTimeEnabled()) return;
+  // Shared, so that modules imported meanwhile nest in the current step.
+  static auto** current = static_cast<Span**>(ProcessWideObject(
+      kImportTimerName, [] { return static_cast<void*>(new Span*{}); }));
+  current_ = current;
+  // Nest in Python's line for the module, which is indented by the number of
+  // enclosing imports (the module's own import included).
+  int level = PythonImportLevel();
+  Begin(&total_, name);
+  if (level > 0) total_.depth = level - 1;
+}
+
+ImportTimer::~ImportTimer() {
+  if (current_ == nullptr) return;
+  if (in_step_) End(&step_);
+  End(&total_);
+}
+
+void ImportTimer::Step(const char* name) {
+  if (current_ == nullptr) return;
+  if (in_step_) End(&step_);
+  Begin(&step_, name);
+  in_step_ = true;
+}
+
+void ImportTimer::Begin(Span* span, const char* name) {
+  span->name = name;
+  span->children_us = 0;
+  span->parent = *current_;
+  span->depth = span->parent ? span->parent->depth + 1 : 0;
+  *current_ = span;
+  span->start_us = NowMicros();
+}
+
+void ImportTimer::End(Span* span) {
+  long long cumulative = NowMicros() - span->start_us;  // NOLINT: runtime/int
+  *current_ = span->parent;
+  if (span->parent != nullptr) span->parent->children_us += cumulative;
+  // Same format as Python's -X importtime.
+  fprintf(stderr, "import time: %9lld | %10lld | %*s%s: %s\n",
+          cumulative - span->children_us, cumulative, 2 * span->depth + 2, "",
+          module_, span->name);
+}
+
 }  // namespace clif
@@ -23,7 +23,11 @@ standard headers on some systems, you must include Python.h before any standard
 headers are included.
 */
 #include <Python.h>
+#include <atomic>
+#include <cstddef>
+#include <map>
 #include <string>
+#include <vector>
 #include "clif/python/instance.h"
 using std::string;
 
@@ -34,6 +38,9 @@ namespace python {
 
 std::string ExcStr(bool add_type = true);
 
+// Returns the readable C++ type name for typeid(T).name().
+std::string Demangle(const char* mangled);
+
 template <typename T>
 T* Get(const clif::Instance<T>& cpp, bool set_err = true) {
   T* d = cpp.get();
@@ -183,6 +190,96 @@ bool ensure_no_args_and_kw_args(const char* func, PyObject* args, PyObject* kw);
 // https://docs.python.org/3/library/pickle.html#object.__reduce_ex__
 PyObject* ReduceExImpl(PyObject* self, PyObject* args, PyObject* kw);
 
+// Returns the object stored in the sys module as |name|, storing create() there
+// first if needed. This shares state among all CLIF extensions in the process
+// even when each one links the runtime statically. Needs the GIL.
+void* ProcessWideObject(const char* name, void* (*create)());
+
+// Live and created wrapper objects of a wrapped class (and its Python
+// subclasses), updated by its generated _new/_tp_new/_dtor.
+struct InstanceCounter {
+  const char* cpp_type;
+  std::size_t cpp_size;
+  std::atomic<long long> live{0};   // NOLINT: runtime/int
+  std::atomic<long long> total{0};  // NOLINT: runtime/int
+
+  void Created() {
+    live.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+  }
+  void Destroyed() { live.fetch_sub(1, std::memory_order_relaxed); }
+};
+
+// Adds |counter| of the |py_type| wrapper to GetInstanceStats().
+void RegisterInstanceCounter(const char* py_type, InstanceCounter* counter);
+
+struct InstanceStats {
+  std::string py_type;
+  std::string cpp_type;
+  long long cpp_size;  // NOLINT: runtime/int
+  long long live;      // NOLINT: runtime/int
+  long long total;     // NOLINT: runtime/int
+};
+
+// Returns the counters of all wrapped classes, most live instances first.
+std::vector<InstanceStats> GetInstanceStats();
+
+// Reports (on=true) the C++ objects owned by wrappers to tracemalloc, so they
+// are attributed to the Python code that created them. Each C++ type has its
+// own tracemalloc domain, see AllocationTracingDomains(). Objects are reported
+// when the wrapper takes ownership, with sizeof(T) and ClifOwnedHeapBytes (see
+// instance.h), only while tracing is on. Needs the GIL.
+void EnableAllocationTracing(bool on);
+bool IsAllocationTracingEnabled();
+
+// Returns the C++ type of each tracemalloc domain used for wrapped objects.
+std::map<int, std::string> AllocationTracingDomains();
+
+// Times the import steps (Ready() and Init()) of a module generated with
+// pyclif --importtime. When Python runs with -X importtime (or
+// PYTHONPROFILEIMPORTTIME) they are reported to stderr in the same format,
+// nested in the module's own line, also when it is imported by another
+// module. The self time of a step excludes the steps of CLIF modules it
+// imports. Needs the GIL.
+class ImportTimer {
+ public:
+  ImportTimer(const char* module, const char* name);
+  ~ImportTimer();
+  ImportTimer(const ImportTimer&) = delete;
+  ImportTimer& operator=(const ImportTimer&) = delete;
+
+  // Ends the previous step and starts timing |name|.
+  void Step(const char* name);
+
+  struct Span {
+    const char* name;
+    long long start_us;         // NOLINT: runtime/int
+    long long children_us = 0;  // NOLINT: runtime/int
+    int depth = 0;
+    Span* parent = nullptr;
+  };
+
+ private:
+  void Begin(Span* span, const char* name);
+  void End(Span* span);
+
+  const char* module_;
+  Span** current_ = nullptr;  // Innermost running span, nullptr if disabled.
+  Span total_;
+  Span step_;
+  bool in_step_ = false;
+};
+
+// Generated __sizeof__: the wrapper object plus the C++ object it owns.
+template <typename T>
+PyObject* SizeOf(PyObject* self, const Instance<T>& cpp) {
+  std::size_t size = Py_TYPE(self)->tp_basicsize;
+  if (cpp.owned() && cpp != nullptr) {
+    size += sizeof(T) + OwnedHeapBytes(*cpp, 0);
+  }
+  return PyLong_FromSize_t(size);
+}
+
 }  // namespace clif
 
 #endif  // CLIF_PYTHON_RUNTIME_H_
@@ -50,6 +50,12 @@ Py_ssize_t as_hash(PyObject* res);
 int as_cmp(PyObject* res);
 int ignore(PyObject* res);
 
+// Python hash of a C++ hasher result (-1 is the tp_hash error value).
+inline Py_hash_t hash_value(size_t h) {
+  Py_hash_t r = static_cast<Py_hash_t>(h);
+  return r == -1 ? -2 : r;
+}
+
 template<PyObject* (*Wrapper)(PyObject*, PyObject*, PyObject*)>
 PyObject* repeat(PyObject* self, Py_ssize_t count) {
   PyObject* i = PyLong_FromSsize_t(count);
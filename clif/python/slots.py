@@ -226,6 +226,7 @@ _SUBSLOT_INFO = (
     ('nb', 'tp_as_number', 'PyNumberMethods', 'AsNumberStaticAlloc'),
     ('sq', 'tp_as_sequence', 'PySequenceMethods', 'AsSequenceStaticAlloc'),
     ('mp', 'tp_as_mapping', 'PyMappingMethods', 'AsMappingStaticAlloc'),
+    ('bf', 'tp_as_buffer', 'PyBufferProcs', 'AsBufferStaticAlloc'),
     # New in Python 3.5, currently not supported.
     # ('am', 'tp_as_async', PyAsyncMethods, None),
 )
@@ -249,7 +250,8 @@ def GenTypeSlotsHeaptype(tracked_slot_groups, tp_group):
     if slot in ('tp_as_number',
                 'tp_as_sequence',
                 'tp_as_mapping',
-                'tp_as_async'):
+                'tp_as_async',
+                'tp_as_buffer'):
       # Using heap_type->as_number, ... slots, assigned in gen.py.
       continue
     if slot == 'tp_flags':
@@ -388,6 +388,7 @@ class Func {
 
   R operator()(T... arg) const {
     GilLock holder;  // Hold GIL during Python callback.
+    CLIF_PROBE1(callback__entry, Py_TYPE(callback_.get())->tp_name);
     int nargs = sizeof...(T);
     PyObject* pyargs = PyTuple_New(nargs);
     if (pyargs && nargs) ArgIn(&pyargs, 0, pc_, std::forward<T>(arg)...);
@@ -528,6 +529,8 @@ typename ForwardedType<T, U>::type forward_subobject(U &&u) {
 
 template<typename T>
 PyObject* ListFromSizableCont(T&& c, const py::PostConv& pc) {
+  profile::ConversionTimer timer(typeid(c), profile::Direction::kToPy);
+  timer.AddItems(c.size());
   PyObject* py = PyList_New(c.size());
   if (py == nullptr) return nullptr;
   const py::PostConv& pct = pc.Get(0);
@@ -564,6 +567,8 @@ PyObject* ListFromIterators(T begin, T end, const py::PostConv& pc) {
 template<typename T>
 PyObject* DictFromCont(T&& c, const py::PostConv& pc) {
   using std::get;
+  profile::ConversionTimer timer(typeid(c), profile::Direction::kToPy);
+  timer.AddItems(c.size());
   PyObject* py = PyDict_New();
   if (py == nullptr) return nullptr;
   const py::PostConv& pck = pc.Get(0);
@@ -586,6 +591,8 @@ PyObject* DictFromCont(T&& c, const py::PostConv& pc) {
 
 template<typename T>
 PyObject* SetFromCont(const T& c, const py::PostConv& pc) {
+  profile::ConversionTimer timer(typeid(c), profile::Direction::kToPy);
+  timer.AddItems(c.size());
   PyObject* py = PySet_New(0);
   if (py == nullptr) return nullptr;
   const py::PostConv& pct = pc.Get(0);
@@ -698,6 +705,8 @@ PyObject* Clif_PyObjFrom(const std::vector<T, Args...>& c,
 template<typename... Args>
 PyObject* Clif_PyObjFrom(const std::vector<bool, Args...>& c,
                          const py::PostConv& pc) {
+  profile::ConversionTimer timer(typeid(c), profile::Direction::kToPy);
+  timer.AddItems(c.size());
   return py::ListFromIterators(c.cbegin(), c.cend(), pc);
 }
 template<typename T, typename... Args>
@@ -707,6 +716,8 @@ PyObject* Clif_PyObjFrom(std::vector<T, Args...>&& c, const py::PostConv& pc) {
 template <typename... Args>
 PyObject* Clif_PyObjFrom(std::vector<bool, Args...>&& c,
                          const py::PostConv& pc) {
+  profile::ConversionTimer timer(typeid(c), profile::Direction::kToPy);
+  timer.AddItems(c.size());
   return py::ListFromIterators(c.cbegin(), c.cend(), pc);
 }
 template<typename T, typename... Args>
@@ -851,20 +862,24 @@ bool ItemsToMap(PyObject* py, F add) {
 template<typename T, typename... Args>
 bool Clif_PyObjAs(PyObject* py, std::vector<T, Args...>* c) {
   CHECK(c != nullptr);
+  profile::ConversionTimer timer(typeid(*c), profile::Direction::kToCpp);
   c->clear();
-  return py::IterToCont<T>(py, [&c](T&& i) {  //NOLINT: build/c++11
+  return py::IterToCont<T>(py, [&c, &timer](T&& i) {  //NOLINT: build/c++11
     c->push_back(std::move(i));
+    timer.AddItems(1);
   });
 }
 
 template <typename T, std::size_t N>
 bool Clif_PyObjAs(PyObject* py, std::array<T, N>* c) {
   CHECK(c != nullptr);
+  profile::ConversionTimer timer(typeid(*c), profile::Direction::kToCpp);
 
   int index = 0;
-  bool rval = py::IterToCont<T>(py, [&c, &index](T&& i) {
+  bool rval = py::IterToCont<T>(py, [&c, &index, &timer](T&& i) {
     if (index < N) {
       (*c)[index] = std::move(i);
+      timer.AddItems(1);
     }
     ++index;  // Continue to increment, so we know true size for reporting.
   });
@@ -879,17 +894,21 @@ bool Clif_PyObjAs(PyObject* py, std::array<T, N>* c) {
 template<typename T, typename... Args>
 bool Clif_PyObjAs(PyObject* py, std::unordered_set<T, Args...>* c) {
   CHECK(c != nullptr);
+  profile::ConversionTimer timer(typeid(*c), profile::Direction::kToCpp);
   c->clear();
-  return py::IterToCont<T>(py, [&c](T&& i) {  //NOLINT: build/c++11
+  return py::IterToCont<T>(py, [&c, &timer](T&& i) {  //NOLINT: build/c++11
     c->insert(std::move(i));
+    timer.AddItems(1);
   });
 }
 template<typename T, typename... Args>
 bool Clif_PyObjAs(PyObject* py, std::set<T, Args...>* c) {
   CHECK(c != nullptr);
+  profile::ConversionTimer timer(typeid(*c), profile::Direction::kToCpp);
   c->clear();
-  return py::IterToCont<T>(py, [&c](T&& i) {  //NOLINT: build/c++11
+  return py::IterToCont<T>(py, [&c, &timer](T&& i) {  //NOLINT: build/c++11
     c->insert(std::move(i));
+    timer.AddItems(1);
   });
 }
 
@@ -897,18 +916,22 @@ bool Clif_PyObjAs(PyObject* py, std::set<T, Args...>* c) {
 template<typename T, typename U, typename... Args>
 bool Clif_PyObjAs(PyObject* py, std::unordered_map<T, U, Args...>* c) {
   CHECK(c != nullptr);
+  profile::ConversionTimer timer(typeid(*c), profile::Direction::kToCpp);
   c->clear();
-  return py::ItemsToMap<T, U>(py, [&c](typename std::pair<T, U>&& i) {  //NOLINT: build/c++11
+  return py::ItemsToMap<T, U>(py, [&c, &timer](typename std::pair<T, U>&& i) {  //NOLINT: build/c++11
     // TODO: Use insert_or_assign since c++17
     (*c)[i.first] = std::move(i.second);
+    timer.AddItems(1);
   });
 }
 template<typename T, typename U, typename... Args>
 bool Clif_PyObjAs(PyObject* py, std::map<T, U, Args...>* c) {
   CHECK(c != nullptr);
+  profile::ConversionTimer timer(typeid(*c), profile::Direction::kToCpp);
   c->clear();
-  return py::ItemsToMap<T, U>(py, [&c](typename std::pair<T, U>&& i) {  //NOLINT: build/c++11
+  return py::ItemsToMap<T, U>(py, [&c, &timer](typename std::pair<T, U>&& i) {  //NOLINT: build/c++11
     (*c)[i.first] = std::move(i.second);
+    timer.AddItems(1);
   });
 }
 }  // namespace clif
@@ -22,6 +22,8 @@ namespace clif {
 
 // bytes
 PyObject* Clif_PyObjFrom(const std::string& c, const py::PostConv& pc) {
+  profile::ConversionTimer timer(typeid(c), profile::Direction::kToPy);
+  timer.AddItems(c.size());
   return pc.Apply(PyBytes_FromStringAndSize(c.data(), c.size()));
 }
 
@@ -313,7 +315,10 @@ bool ObjToStr(PyObject* py, C copy) {
 
 bool Clif_PyObjAs(PyObject* p, std::string* c) {
   CHECK(c != nullptr);
-  return py::ObjToStr(p,
-      [c](const char* data, size_t length) { c->assign(data, length); });
+  profile::ConversionTimer timer(typeid(*c), profile::Direction::kToCpp);
+  return py::ObjToStr(p, [c, &timer](const char* data, size_t length) {
+    c->assign(data, length);
+    timer.AddItems(length);
+  });
 }
 }  // namespace clif
@@ -57,7 +57,9 @@ headers are included.
 // #include's directly.  But that file is not parsed for "CLIF" use statements.
 // CLIF use `::std::variant` as OneOf
 
+#include "clif/python/conversion_profile.h"
 #include "clif/python/postconv.h"
+#include "clif/python/probes.h"
 // Protobuf type declared here because subincludes are not scanned for types.
 // CLIF use `::proto2::Message` as proto2_Message
 #include "clif/python/pyproto.h"
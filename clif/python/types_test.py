@@ -62,6 +62,25 @@ class TypesTest(absltest.TestCase):
       typename std::enable_if<std::is_same<T, c::name::cpp_name>::value>::type Clif_PyObjFrom(const c::name::cpp_name&, py::PostConv) = delete;
     """))
 
+  def testClassTypeInterop(self):
+    ns = 'clif::name::'
+    w = ns+'wrapper'
+    t = types.ClassType('c::name::cpp_name', 'fq.py.path', w, w+'_Type', ns,
+                        can_copy=True, can_move=True, can_destruct=True,
+                        virtual='', interop=True)
+    converters = '\n'.join(t.GenConverters('m'))
+    self.assertIn('\n'.join([
+        '  if (!PyObject_TypeCheck(py, m::clif::name::wrapper_Type)) {',
+        '    if (::clif::interop::GetSharedPtr(py, c)) return true;',
+        '    if (PyErr_Occurred()) return false;',
+        '  }']), converters)
+    this_ptr = '\n'.join(types.GenThisPointerFunc('c::name::cpp_name',
+                                                  interop=True))
+    self.assertIn('std::shared_ptr<c::name::cpp_name> foreign;', this_ptr)
+    self.assertIn('if (::clif::interop::GetSharedPtr(py, &foreign))'
+                  ' return foreign.get();', this_ptr)
+    self.assertIn('if (PyErr_Occurred()) return nullptr;', this_ptr)
+
   def testUncopyableButMovableClassType(self):
     ns = 'clif::name::'
     w = ns+'wrapper'
@@ -92,6 +111,17 @@ class TypesTest(absltest.TestCase):
       bool Clif_PyObjAs(PyObject* input, c::name::cpp_name* output);
       PyObject* Clif_PyObjFrom(const c::name::cpp_name&, py::PostConv);
     """))
+    converters = '\n'.join(t.GenConverters('ns'))
+    self.assertIn(
+        'bool Clif_PyObjAs(PyObject* py, c::name::cpp_name* c) {\n'
+        '  CHECK(c != nullptr);\n'
+        '  ::clif::profile::ConversionTimer timer(typeid(*c), '
+        '::clif::profile::Direction::kToCpp);\n', converters)
+    self.assertIn(
+        'PyObject* Clif_PyObjFrom(const c::name::cpp_name& c, '
+        'py::PostConv) {\n'
+        '  ::clif::profile::ConversionTimer timer(typeid(c), '
+        '::clif::profile::Direction::kToPy);\n', converters)
 
   def testProtoType(self):
     t = types.ProtoType('c::cpp_name', 'fq.py.path', 'some.project.my_pb2')
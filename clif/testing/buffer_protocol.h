@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_TESTING_BUFFER_PROTOCOL_H_
+#define CLIF_TESTING_BUFFER_PROTOCOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace clif_testing {
+namespace buffer_protocol {
+
+// A writable 1-D buffer: data() and size().
+class Samples {
+ public:
+  explicit Samples(int n) : values_(n) {}
+  float* data() { return values_.data(); }
+  std::size_t size() const { return values_.size(); }
+  float Get(int i) const { return values_[i]; }
+
+ private:
+  std::vector<float> values_;
+};
+
+inline int Consume(std::unique_ptr<Samples> samples) {
+  return static_cast<int>(samples->size());
+}
+
+// A read-only height x width x RGB image, pixel (y, x) is {y, x, 0}.
+class Image {
+ public:
+  Image(int height, int width) : height_(height), width_(width) {
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        pixels_.insert(pixels_.end(), {static_cast<std::uint8_t>(y),
+                                       static_cast<std::uint8_t>(x), 0});
+      }
+    }
+  }
+  const std::uint8_t* pixels() const { return pixels_.data(); }
+  std::vector<int> dims() const { return {height_, width_, 3}; }
+
+ private:
+  int height_;
+  int width_;
+  std::vector<std::uint8_t> pixels_;
+};
+
+// A rows x cols matrix stored by column, element (i, j) is 10 * i + j.
+class Matrix {
+ public:
+  Matrix(int rows, int cols) : rows_(rows), cols_(cols), values_(rows * cols) {
+    for (int j = 0; j < cols; ++j) {
+      for (int i = 0; i < rows; ++i) values_[j * rows + i] = 10 * i + j;
+    }
+  }
+  double* data() { return values_.data(); }
+  std::vector<int> dims() const { return {rows_, cols_}; }
+  std::vector<std::size_t> byte_strides() const {
+    return {sizeof(double), rows_ * sizeof(double)};
+  }
+
+ private:
+  int rows_;
+  int cols_;
+  std::vector<double> values_;
+};
+
+// Packed records, exported with a struct format.
+class Records {
+ public:
+#pragma pack(push, 1)
+  struct Record {
+    std::int32_t id;
+    float score;
+  };
+#pragma pack(pop)
+
+  explicit Records(int n) : records_(n) {
+    for (int i = 0; i < n; ++i) records_[i] = {i, 0.5f * i};
+  }
+  Record* data() { return records_.data(); }
+  std::size_t size() const { return records_.size(); }
+  const char* format() const { return "<if"; }
+
+ private:
+  std::vector<Record> records_;
+};
+
+}  // namespace buffer_protocol
+}  // namespace clif_testing
+
+#endif  // CLIF_TESTING_BUFFER_PROTOCOL_H_
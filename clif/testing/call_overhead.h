@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_TESTING_CALL_OVERHEAD_H_
+#define CLIF_TESTING_CALL_OVERHEAD_H_
+
+// Trivial C++ functions, so that wrapper overhead dominates the call time
+// measured by python/call_overhead_benchmark.py.
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace clif_testing {
+namespace call_overhead {
+
+inline void NoArgs() {}
+
+inline int IntId(int x) { return x; }
+
+inline std::string StringId(const std::string& s) { return s; }
+
+inline std::vector<int> VectorId(const std::vector<int>& v) { return v; }
+
+inline int CallCallback(std::function<int(int)> cb, int x) { return cb(x); }
+
+class Worker {
+ public:
+  virtual ~Worker() = default;
+  virtual int Work(int x) { return x; }
+};
+
+inline int CallWork(Worker* w, int x) { return w->Work(x); }
+
+struct Point {
+  Point() = default;
+  Point(int x, int y) : x(x), y(y) {}
+  int x = 0;
+  int y = 0;
+};
+
+}  // namespace call_overhead
+}  // namespace clif_testing
+
+#endif  // CLIF_TESTING_CALL_OVERHEAD_H_
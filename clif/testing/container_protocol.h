@@ -0,0 +1,79 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_TESTING_CONTAINER_PROTOCOL_H_
+#define CLIF_TESTING_CONTAINER_PROTOCOL_H_
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace clif_testing {
+namespace container_protocol {
+
+// A sequence: size() and operator[].
+class IntList {
+ public:
+  explicit IntList(std::vector<int> values) : values_(std::move(values)) {}
+  std::size_t size() const { return values_.size(); }
+  int operator[](std::size_t i) const { return values_[i]; }
+
+ private:
+  std::vector<int> values_;
+};
+
+// A mapping: key_type, mapped_type, find() and count().
+class Registry {
+ public:
+  using key_type = std::string;
+  using mapped_type = int;
+  using const_iterator = std::map<std::string, int>::const_iterator;
+
+  void Add(const std::string& name, int value) { entries_[name] = value; }
+  std::size_t size() const { return entries_.size(); }
+  const_iterator find(const std::string& name) const {
+    return entries_.find(name);
+  }
+  const_iterator end() const { return entries_.end(); }
+  std::size_t count(const std::string& name) const {
+    return entries_.count(name);
+  }
+
+ private:
+  std::map<std::string, int> entries_;
+};
+
+// A set: key_type and contains().
+class Names {
+ public:
+  using key_type = std::string;
+
+  void Add(const std::string& name) { names_.insert(name); }
+  std::size_t size() const { return names_.size(); }
+  bool contains(const std::string& name) const {
+    return names_.count(name) != 0;
+  }
+
+ private:
+  std::set<std::string> names_;
+};
+
+}  // namespace container_protocol
+}  // namespace clif_testing
+
+#endif  // CLIF_TESTING_CONTAINER_PROTOCOL_H_
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_TESTING_MEMBER_VIEW_H_
+#define CLIF_TESTING_MEMBER_VIEW_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace clif_testing {
+namespace member_view {
+
+struct Record {
+  std::vector<int> values;
+  std::map<std::string, int> counts;
+  std::set<std::string> tags;
+  std::vector<int> copied;
+
+  int Sum() const {
+    int sum = 0;
+    for (int v : values) sum += v;
+    return sum;
+  }
+  int Count(const std::string& name) const {
+    auto it = counts.find(name);
+    return it == counts.end() ? 0 : it->second;
+  }
+  bool HasTag(const std::string& tag) const { return tags.count(tag) != 0; }
+};
+
+}  // namespace member_view
+}  // namespace clif_testing
+
+#endif  // CLIF_TESTING_MEMBER_VIEW_H_
@@ -0,0 +1,73 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for testing.buffer_protocol (the class buffer statement)."""
+
+import gc
+
+from absl.testing import absltest
+
+from clif.testing.python import buffer_protocol
+
+
+class BufferProtocolTest(absltest.TestCase):
+
+  def testWritable(self):
+    samples = buffer_protocol.Samples(3)
+    view = memoryview(samples)
+    self.assertFalse(view.readonly)
+    self.assertEqual(view.format, 'f')
+    self.assertEqual(view.shape, (3,))
+    view[1] = 1.5
+    self.assertEqual(samples.Get(1), 1.5)
+
+  def testViewKeepsInstance(self):
+    view = memoryview(buffer_protocol.Samples(2))
+    gc.collect()
+    view[0] = 2.5
+    self.assertEqual(view.tolist(), [2.5, 0.0])
+
+  def testNoTransferWhileExported(self):
+    samples = buffer_protocol.Samples(2)
+    with memoryview(samples):
+      with self.assertRaises(ValueError):
+        buffer_protocol.Consume(samples)
+    self.assertEqual(buffer_protocol.Consume(samples), 2)
+
+  def testReadOnly(self):
+    view = memoryview(buffer_protocol.Image(2, 3))
+    self.assertTrue(view.readonly)
+    self.assertEqual(view.format, 'B')
+    self.assertEqual(view.shape, (2, 3, 3))
+    self.assertEqual(view.tolist()[1][2], [1, 2, 0])
+    with self.assertRaises(TypeError):
+      view[0, 0, 0] = 1
+
+  def testStrided(self):
+    view = memoryview(buffer_protocol.Matrix(2, 3))
+    self.assertEqual(view.strides, (8, 16))
+    self.assertFalse(view.c_contiguous)
+    self.assertTrue(view.f_contiguous)
+    self.assertEqual(view.tolist(), [[0, 1, 2], [10, 11, 12]])
+
+  def testFormat(self):
+    view = memoryview(buffer_protocol.Records(4))
+    self.assertEqual(view.format, '<if')
+    self.assertEqual(view.itemsize, 8)
+    self.assertEqual(view.nbytes, 32)
+    self.assertEqual(view.cast('B')[4:8].tobytes(), b'\0\0\0\0')
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,125 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Compare per-call overhead of CLIF backends on the same wrapped C++ code.
+
+Each backend is a Python package containing the call_overhead and t4
+extension modules generated from call_overhead.clif and t4.clif, e.g. the
+C API backend built by the CMake runPyClifIntegrationTests target and a
+package built with the pybind11 code generator:
+
+  python call_overhead_benchmark.py \
+      --backend c_api=clif.testing.python \
+      --backend pybind11=clif.testing.python.pybind11 [--json]
+
+The result is the best of --repeat runs of --number calls, in ns per call.
+"""
+
+import argparse
+import importlib
+import json
+import sys
+import timeit
+
+from clif.protos import ast_pb2
+
+SCENARIOS = ('no_args', 'int', 'str', 'list', 'proto', 'virtual_override',
+             'callback', 'construct')
+
+
+def _Calls(package):
+  """Return {scenario: no-argument callable} for the backend package."""
+  m = importlib.import_module(package + '.call_overhead')
+  t4 = importlib.import_module(package + '.t4')
+
+  class Override(m.Worker):
+
+    def Work(self, x):
+      return x
+
+  s = 'x' * 16
+  v = list(range(16))
+  pb = ast_pb2.AST()
+  worker = Override()
+  cb = lambda x: x
+  return {
+      'no_args': m.NoArgs,
+      'int': lambda: m.IntId(1),
+      'str': lambda: m.StringId(s),
+      'list': lambda: m.VectorId(v),
+      'proto': lambda: t4.Size(pb),
+      'virtual_override': lambda: m.CallWork(worker, 1),
+      'callback': lambda: m.CallCallback(cb, 1),
+      'construct': lambda: m.Point(1, 2),
+  }
+
+
+def Run(backends, number=100000, repeat=5):
+  """Return {scenario: {backend: ns per call}}."""
+  results = {s: {} for s in SCENARIOS}
+  for name, package in backends.items():
+    calls = _Calls(package)
+    for scenario in SCENARIOS:
+      t = min(timeit.repeat(calls[scenario], number=number, repeat=repeat))
+      results[scenario][name] = t / number * 1e9
+  return results
+
+
+def FormatJson(results):
+  backends = sorted({b for r in results.values() for b in r})
+  return json.dumps({'unit': 'ns/call', 'backends': backends,
+                     'results': results}, indent=2, sort_keys=True)
+
+
+def FormatTable(results):
+  """Return a text table, with ratios to the first backend column."""
+  backends = list(results[SCENARIOS[0]])
+  lines = ['%-18s' % 'ns/call' + ''.join('%16s' % b for b in backends)]
+  for scenario in SCENARIOS:
+    row = results[scenario]
+    base = row[backends[0]]
+    cells = ['%16.1f' % row[backends[0]]]
+    for b in backends[1:]:
+      cells.append('%9.1f %5.2fx' % (row[b], row[b] / base))
+    lines.append('%-18s' % scenario + ''.join(cells))
+  return '\n'.join(lines)
+
+
+def _Backend(arg):
+  name, sep, package = arg.partition('=')
+  if not sep or not name or not package:
+    raise argparse.ArgumentTypeError('expected NAME=PACKAGE, got %r' % arg)
+  return name, package
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('--backend', type=_Backend, action='append',
+                      metavar='NAME=PACKAGE',
+                      help='backend to measure, may be repeated'
+                      ' (default c_api=clif.testing.python)')
+  parser.add_argument('--number', type=int, default=100000,
+                      help='calls per timing run')
+  parser.add_argument('--repeat', type=int, default=5,
+                      help='timing runs per scenario, the best is reported')
+  parser.add_argument('--json', action='store_true',
+                      help='print JSON instead of a table')
+  args = parser.parse_args(argv[1:])
+  backends = dict(args.backend or [('c_api', 'clif.testing.python')])
+  results = Run(backends, args.number, args.repeat)
+  print(FormatJson(results) if args.json else FormatTable(results))
+
+
+if __name__ == '__main__':
+  main(sys.argv)
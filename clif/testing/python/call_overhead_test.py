@@ -0,0 +1,59 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for testing.call_overhead and its benchmark."""
+
+import json
+
+from absl.testing import absltest
+
+from clif.testing.python import call_overhead
+from clif.testing.python import call_overhead_benchmark
+
+
+class Doubler(call_overhead.Worker):
+
+  def Work(self, x):
+    return 2 * x
+
+
+class CallOverheadTest(absltest.TestCase):
+
+  def testFunctions(self):
+    self.assertIsNone(call_overhead.NoArgs())
+    self.assertEqual(call_overhead.IntId(7), 7)
+    self.assertEqual(call_overhead.StringId('abc'), 'abc')
+    self.assertEqual(call_overhead.VectorId([1, 2]), [1, 2])
+    self.assertEqual(call_overhead.CallCallback(lambda x: x + 1, 1), 2)
+
+  def testVirtualOverride(self):
+    self.assertEqual(call_overhead.CallWork(call_overhead.Worker(), 3), 3)
+    self.assertEqual(call_overhead.CallWork(Doubler(), 3), 6)
+
+  def testPoint(self):
+    p = call_overhead.Point(1, 2)
+    self.assertEqual((p.x, p.y), (1, 2))
+
+  def testBenchmarkRuns(self):
+    results = call_overhead_benchmark.Run(
+        {'c_api': 'clif.testing.python'}, number=2, repeat=1)
+    self.assertCountEqual(results, call_overhead_benchmark.SCENARIOS)
+    for timings in results.values():
+      self.assertGreater(timings['c_api'], 0)
+    json.loads(call_overhead_benchmark.FormatJson(results))
+    self.assertIn('no_args', call_overhead_benchmark.FormatTable(results))
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,60 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for testing.container_protocol (the @container_protocol decorator)."""
+
+from absl.testing import absltest
+
+from clif.testing.python import container_protocol
+
+
+class ContainerProtocolTest(absltest.TestCase):
+
+  def testSequence(self):
+    values = container_protocol.IntList([1, 2, 3])
+    self.assertLen(values, 3)
+    self.assertEqual(values[0], 1)
+    self.assertEqual(values[-1], 3)
+    with self.assertRaises(IndexError):
+      values[3]  # pylint: disable=pointless-statement
+    # Python iterates and searches by index.
+    self.assertEqual(list(values), [1, 2, 3])
+    self.assertIn(2, values)
+
+  def testMapping(self):
+    registry = container_protocol.Registry()
+    registry.Add('a', 1)
+    self.assertLen(registry, 1)
+    self.assertEqual(registry['a'], 1)
+    with self.assertRaises(KeyError):
+      registry['b']  # pylint: disable=pointless-statement
+    with self.assertRaises(KeyError):
+      registry[1]  # pylint: disable=pointless-statement
+    self.assertIn('a', registry)
+    self.assertNotIn('b', registry)
+    self.assertNotIn(1, registry)
+
+  def testSet(self):
+    names = container_protocol.Names()
+    self.assertEmpty(names)
+    names.Add('x')
+    self.assertLen(names, 1)
+    self.assertIn('x', names)
+    self.assertNotIn('y', names)
+    with self.assertRaises(TypeError):
+      names[0]  # pylint: disable=pointless-statement
+
+
+if __name__ == '__main__':
+  absltest.main()
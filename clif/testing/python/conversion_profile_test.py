@@ -0,0 +1,83 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for clif.python.utils.conversion_profile."""
+
+from absl.testing import absltest
+
+from clif.python.utils import conversion_profile
+from clif.testing.python import std_containers
+from clif.testing.python import t2
+
+
+def _Stats(type_name, direction):
+  return [s for s in conversion_profile.Snapshot()
+          if type_name in s.type and s.direction == direction]
+
+
+def _VectorStats(direction):
+  return _Stats('vector<int', direction)
+
+
+class ConversionProfileTest(absltest.TestCase):
+
+  def setUp(self):
+    super().setUp()
+    conversion_profile.Reset()
+
+  def tearDown(self):
+    conversion_profile.Enable(False)
+    conversion_profile.Reset()
+    super().tearDown()
+
+  def testEnable(self):
+    self.assertFalse(conversion_profile.IsEnabled())
+    conversion_profile.Enable(True)
+    self.assertTrue(conversion_profile.IsEnabled())
+    conversion_profile.Enable(False)
+    self.assertFalse(conversion_profile.IsEnabled())
+
+  def testRecordsContainerConversions(self):
+    conversion_profile.Enable(True)
+    self.assertEqual(std_containers.Mul([1, 2, 3], 2), [2, 4, 6])
+    to_cpp = _VectorStats('py->c++')
+    self.assertLen(to_cpp, 1)
+    self.assertEqual(to_cpp[0].calls, 1)
+    self.assertEqual(to_cpp[0].items, 3)
+    self.assertGreaterEqual(to_cpp[0].nanos, 0)
+    to_py = _VectorStats('c++->py')
+    self.assertLen(to_py, 1)
+    self.assertEqual(to_py[0].items, 3)
+    conversion_profile.Reset()
+    self.assertEmpty(conversion_profile.Snapshot())
+
+  def testRecordsEnumConversions(self):
+    conversion_profile.Enable(True)
+    mgr = t2.CtxMgr()
+    mgr.state = t2.CtxMgr.State.LOCKED
+    self.assertEqual(mgr.state, t2.CtxMgr.State.LOCKED)
+    to_cpp = _Stats('CtxMgr::State', 'py->c++')
+    self.assertLen(to_cpp, 1)
+    self.assertEqual(to_cpp[0].calls, 1)
+    to_py = _Stats('CtxMgr::State', 'c++->py')
+    self.assertLen(to_py, 1)
+    self.assertEqual(to_py[0].calls, 1)
+
+  def testDisabledRecordsNothing(self):
+    std_containers.Mul([1, 2, 3], 2)
+    self.assertEmpty(conversion_profile.Snapshot())
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,56 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for the instance counters and __sizeof__ of wrapped classes."""
+
+import sys
+
+from absl.testing import absltest
+
+from clif.python.utils import runtime
+from clif.testing.python import member_view
+
+
+def _RecordStats():
+  stats = [s for s in runtime.instance_stats()
+           if s.py_type.endswith('.Record') and 'member_view' in s.cpp_type]
+  assert len(stats) == 1, stats
+  return stats[0]
+
+
+class InstanceStatsTest(absltest.TestCase):
+
+  def testCounts(self):
+    before = _RecordStats()
+    records = [member_view.Record() for _ in range(3)]
+    created = _RecordStats()
+    self.assertEqual(created.live, before.live + 3)
+    self.assertEqual(created.total, before.total + 3)
+    del records
+    freed = _RecordStats()
+    self.assertEqual(freed.live, before.live)
+    self.assertEqual(freed.total, before.total + 3)
+
+  def testSizeOf(self):
+    r = member_view.Record()
+    stats = _RecordStats()
+    self.assertGreater(stats.cpp_size, 0)
+    self.assertEqual(r.__sizeof__(),
+                     type(r).__basicsize__ + stats.cpp_size)
+    # Plus the garbage collector header, if any.
+    self.assertGreaterEqual(sys.getsizeof(r), r.__sizeof__())
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,108 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for testing.member_view (the @view var decorator)."""
+
+from absl.testing import absltest
+
+from clif.testing.python import member_view
+
+
+class MemberViewTest(absltest.TestCase):
+
+  def testSequence(self):
+    r = member_view.Record()
+    values = r.values
+    values.append(1)
+    values += [2, 3]
+    values[0] = 10
+    self.assertEqual(r.Sum(), 15)
+    self.assertLen(r.values, 3)
+    self.assertEqual(r.values[-1], 3)
+    self.assertEqual(list(r.values), [10, 2, 3])
+    self.assertEqual(r.values, [10, 2, 3])
+    self.assertIn(2, r.values)
+    self.assertEqual(r.values.pop(), 3)
+    del r.values[0]
+    self.assertEqual(r.Sum(), 2)
+    with self.assertRaises(IndexError):
+      r.values[1]  # pylint: disable=pointless-statement
+    with self.assertRaises(TypeError):
+      hash(r.values)
+
+  def testMapping(self):
+    r = member_view.Record()
+    r.counts['a'] = 1
+    self.assertEqual(r.Count('a'), 1)
+    self.assertEqual(r.counts['a'], 1)
+    self.assertEqual(r.counts.keys(), ['a'])
+    self.assertEqual(r.counts.items(), [('a', 1)])
+    self.assertEqual(r.counts, {'a': 1})
+    self.assertIsNone(r.counts.get('b'))
+    with self.assertRaises(KeyError):
+      r.counts['b']  # pylint: disable=pointless-statement
+    del r.counts['a']
+    self.assertEqual(r.Count('a'), 0)
+
+  def testSet(self):
+    r = member_view.Record()
+    r.tags.add('x')
+    self.assertTrue(r.HasTag('x'))
+    self.assertIn('x', r.tags)
+    self.assertEqual(set(r.tags), {'x'})
+    r.tags.discard('x')
+    self.assertEmpty(r.tags)
+
+  def testMutateWhileIterating(self):
+    r = member_view.Record()
+    r.tags = {'a', 'b'}
+    seen = []
+    for tag in r.tags:
+      seen.append(tag)
+      if tag == 'a':
+        r.tags.discard('b')
+        r.tags.add('c')
+    self.assertEqual(seen, ['a', 'c'])
+    seen = []
+    for tag in r.tags:
+      seen.append(tag)
+      r.tags = {'x', 'y'}  # Replaces the container, keeps its size.
+    self.assertEqual(seen, ['a', 'x', 'y'])
+
+  def testViewKeepsOwnerAlive(self):
+    r = member_view.Record()
+    r.values.append(1)
+    values = r.values
+    del r
+    self.assertEqual(values, [1])
+
+  def testAssign(self):
+    r = member_view.Record()
+    r.values = [1, 2]
+    self.assertEqual(r.Sum(), 3)
+    r.values = r.values  # Not cleared before it is read.
+    self.assertEqual(r.Sum(), 3)
+    other = member_view.Record()
+    other.values = r.values
+    r.values.append(3)
+    self.assertEqual(other.values, [1, 2])
+
+  def testCopiedMember(self):
+    r = member_view.Record()
+    r.copied.append(1)  # Appends to a copy.
+    self.assertEqual(r.copied, [])
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,171 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Measure how wrapped C++ calls scale with the number of Python threads.
+
+Each scenario calls a function of the thread_scaling extension module, which
+runs --steps of C++ work with the GIL released (except spin_gil_held) and in
+the callback and virtual_override scenarios then re-enters Python, taking the
+GIL back with PyGILState_Ensure:
+
+  python thread_scaling_benchmark.py --threads 1,2,4,8 --steps 0,1000,100000
+
+For every scenario and work size the result is the throughput in calls per
+second from 1..N threads and its speedup over one thread. A speedup that stays
+near 1x as threads are added shows the GIL handoff (small work sizes) or the
+re-entry into Python capping the scaling.
+"""
+
+import argparse
+import importlib
+import json
+import sys
+import threading
+import time
+
+SCENARIOS = ('spin', 'spin_gil_held', 'callback', 'virtual_override')
+
+
+def _Calls(package, steps):
+  """Return {scenario: no-argument callable} doing |steps| of C++ work."""
+  m = importlib.import_module(package + '.thread_scaling')
+
+  class Override(m.Worker):
+
+    def Work(self, x):
+      return x
+
+  worker = Override()
+  cb = lambda x: x
+  return {
+      'spin': lambda: m.Spin(steps),
+      'spin_gil_held': lambda: m.SpinHoldingGil(steps),
+      'callback': lambda: m.SpinAndCall(cb, steps),
+      'virtual_override': lambda: m.SpinAndWork(worker, steps),
+  }
+
+
+def _Elapsed(call, threads, calls):
+  """Return the wall time of |threads| threads each making |calls| calls."""
+  start_line = threading.Barrier(threads + 1)
+
+  def Loop():
+    start_line.wait()
+    for _ in range(calls):
+      call()
+
+  workers = [threading.Thread(target=Loop) for _ in range(threads)]
+  for w in workers:
+    w.start()
+  start_line.wait()
+  start = time.perf_counter()
+  for w in workers:
+    w.join()
+  return time.perf_counter() - start
+
+
+def Run(package='clif.testing.python', threads=(1, 2, 4, 8),
+        steps=(0, 1000, 100000), calls=1000, repeat=3):
+  """Return {scenario: {steps: {threads: calls per second}}}."""
+  results = {s: {} for s in SCENARIOS}
+  for n in steps:
+    scenario_calls = _Calls(package, n)
+    for scenario in SCENARIOS:
+      row = results[scenario][n] = {}
+      for t in threads:
+        elapsed = min(_Elapsed(scenario_calls[scenario], t, calls)
+                      for _ in range(repeat))
+        row[t] = t * calls / elapsed
+  return results
+
+
+def FormatJson(results):
+  return json.dumps({'unit': 'calls/s', 'results': results}, indent=2,
+                    sort_keys=True)
+
+
+def FormatTable(results):
+  """Return a text table, with speedups over the first thread count."""
+  threads = list(next(iter(next(iter(results.values())).values())))
+  lines = ['%-18s%8s' % ('calls/s', 'steps') +
+           ''.join('%20s' % ('%d threads' % t) for t in threads)]
+  for scenario in SCENARIOS:
+    for n, row in results[scenario].items():
+      base = row[threads[0]]
+      cells = ['%12.0f %5.2fx' % (row[t], row[t] / base) for t in threads]
+      lines.append('%-18s%8d' % (scenario, n) + ''.join(cells))
+  return '\n'.join(lines)
+
+
+def FormatPlot(results, width=40):
+  """Return a text plot of the speedup per thread count, '|' marks ideal."""
+  lines = []
+  for scenario in SCENARIOS:
+    for n, row in results[scenario].items():
+      threads = list(row)
+      lines.append('%s, %d steps:' % (scenario, n))
+      top = max(threads) / threads[0]
+      for t in threads:
+        speedup = row[t] / row[threads[0]]
+        bar = '#' * int(round(width * min(speedup, top) / top))
+        ideal = int(round(width * (t / threads[0]) / top))
+        bar = bar.ljust(width + 1)
+        bar = bar[:ideal] + '|' + bar[ideal + 1:]
+        lines.append('  %3d %s %.2fx' % (t, bar, speedup))
+  return '\n'.join(lines)
+
+
+def _Ints(arg):
+  try:
+    values = [int(v) for v in arg.split(',')]
+  except ValueError:
+    raise argparse.ArgumentTypeError('expected N[,N...], got %r' % arg)
+  if not values or min(values) < 0:
+    raise argparse.ArgumentTypeError('expected N[,N...], got %r' % arg)
+  return values
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('--package', default='clif.testing.python',
+                      help='package containing the thread_scaling module')
+  parser.add_argument('--threads', type=_Ints, default=[1, 2, 4, 8],
+                      help='comma separated thread counts')
+  parser.add_argument('--steps', type=_Ints, default=[0, 1000, 100000],
+                      help='comma separated C++ work sizes per call')
+  parser.add_argument('--calls', type=int, default=1000,
+                      help='calls per thread per timing run')
+  parser.add_argument('--repeat', type=int, default=3,
+                      help='timing runs per measurement, the best is reported')
+  output = parser.add_mutually_exclusive_group()
+  output.add_argument('--json', action='store_true',
+                      help='print JSON instead of a table')
+  output.add_argument('--plot', action='store_true',
+                      help='also print a text plot of the speedups')
+  args = parser.parse_args(argv[1:])
+  if 0 in args.threads:
+    parser.error('--threads must be positive')
+  results = Run(args.package, args.threads, args.steps, args.calls,
+                args.repeat)
+  if args.json:
+    print(FormatJson(results))
+    return
+  print(FormatTable(results))
+  if args.plot:
+    print()
+    print(FormatPlot(results))
+
+
+if __name__ == '__main__':
+  main(sys.argv)
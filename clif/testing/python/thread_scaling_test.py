@@ -0,0 +1,62 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for testing.thread_scaling and its benchmark."""
+
+import json
+
+from absl.testing import absltest
+
+from clif.testing.python import thread_scaling
+from clif.testing.python import thread_scaling_benchmark
+
+
+class Doubler(thread_scaling.Worker):
+
+  def Work(self, x):
+    return 2 * x
+
+
+class ThreadScalingTest(absltest.TestCase):
+
+  def testSpin(self):
+    self.assertEqual(thread_scaling.Spin(0), 0)
+    self.assertEqual(thread_scaling.Spin(100),
+                     thread_scaling.SpinHoldingGil(100))
+
+  def testReentry(self):
+    spin = thread_scaling.Spin(10)
+    self.assertEqual(thread_scaling.SpinAndCall(lambda x: x + 1, 10),
+                     spin + 1)
+    self.assertEqual(
+        thread_scaling.SpinAndWork(thread_scaling.Worker(), 10), spin)
+    self.assertEqual(thread_scaling.SpinAndWork(Doubler(), 1), 2 * 507784374)
+
+  def testBenchmarkRuns(self):
+    results = thread_scaling_benchmark.Run(threads=(1, 2), steps=(0, 10),
+                                           calls=2, repeat=1)
+    self.assertCountEqual(results, thread_scaling_benchmark.SCENARIOS)
+    for rows in results.values():
+      self.assertCountEqual(rows, (0, 10))
+      for row in rows.values():
+        self.assertCountEqual(row, (1, 2))
+        self.assertGreater(min(row.values()), 0)
+    json.loads(thread_scaling_benchmark.FormatJson(results))
+    self.assertIn('virtual_override',
+                  thread_scaling_benchmark.FormatTable(results))
+    self.assertIn('2 ', thread_scaling_benchmark.FormatPlot(results))
+
+
+if __name__ == '__main__':
+  absltest.main()
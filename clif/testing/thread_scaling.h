@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CLIF_TESTING_THREAD_SCALING_H_
+#define CLIF_TESTING_THREAD_SCALING_H_
+
+// C++ work of a given size for python/thread_scaling_benchmark.py, called
+// with the GIL released (except SpinHoldingGil) and re-entering Python from
+// C++ through a callback or a virtual method override.
+
+#include <functional>
+
+namespace clif_testing {
+namespace thread_scaling {
+
+// Runs |steps| steps of a linear congruential generator, the result depends
+// on every step so that the loop is not optimized away.
+inline int Spin(int steps) {
+  unsigned int x = static_cast<unsigned int>(steps);
+  for (int i = 0; i < steps; ++i) x = x * 1664525u + 1013904223u;
+  return static_cast<int>(x >> 1);
+}
+
+inline int SpinHoldingGil(int steps) { return Spin(steps); }
+
+inline int SpinAndCall(std::function<int(int)> cb, int steps) {
+  return cb(Spin(steps));
+}
+
+class Worker {
+ public:
+  virtual ~Worker() = default;
+  virtual int Work(int x) { return x; }
+};
+
+inline int SpinAndWork(Worker* w, int steps) { return w->Work(Spin(steps)); }
+
+}  // namespace thread_scaling
+}  // namespace clif_testing
+
+#endif  // CLIF_TESTING_THREAD_SCALING_H_